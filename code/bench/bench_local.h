@@ -0,0 +1,12 @@
+// Copyright (C) 2023-2025 Noire.dev
+// OpenSandbox — GPLv2; see LICENSE for details.
+
+// bench_syscalls.c
+void Host_Write(const char *text);
+void Host_Exit(int code);
+int Host_Microseconds(void);
+void Bench_SetArgs(const char *text);
+void Bench_AddFile(const char *name, char *data, int len);
+
+// g_main.c
+intptr_t vmMain(int command, int arg0, int arg1, int arg2);
@@ -0,0 +1,406 @@
+// Copyright (C) 2023-2025 Noire.dev
+// OpenSandbox — GPLv2; see LICENSE for details.
+
+// Headless game benchmark: loads a synthetic prop scene through the
+// mapfile loader and times G_RunFrame and AI_Frame against the stub engine.
+//
+// gamebench [-props N] [-layers N] [-frames N] [-msec N] [-weld N]
+//           [-autosave N] [-budget N] [-profile 1]
+//
+// -weld N saves the props in welded groups of N under entity numbers
+// that differ from the ones they load into, and checks that loadmap
+// restores every weld. It also loads a scene with more props than
+// g_maxEntities, which must stop cleanly with every weld on a prop
+//
+// The run ends with a vehicle that is parked until it sleeps, then
+// driven and left, it must be simulated again once the driver is out
+//
+// -autosave N journals the scene every N seconds within a frame budget
+// of -budget msec, -profile 1 prints the game's frame profile
+//
+// After the run the scene is saved in both mapfile formats and each
+// save, and the autosave, is loaded back and checked
+
+#include "../shared/javascript.h"
+#include "bench_local.h"
+
+#define BENCH_MAX_FRAMES 10000
+#define BENCH_SCENE_SIZE 0x200000
+#define BENCH_PROP_SIZE 15
+#define BENCH_PROP_SPACING 40
+
+// process entry, no libc: hand argc/argv to Bench_Main on an aligned stack
+__asm__(".globl _start\n"
+        "_start:\n"
+        "	xor %ebp, %ebp\n"
+        "	mov (%esp), %eax\n"
+        "	lea 4(%esp), %edx\n"
+        "	and $-16, %esp\n"
+        "	sub $8, %esp\n"
+        "	push %edx\n"
+        "	push %eax\n"
+        "	call Bench_Main\n"
+        "	push %eax\n"
+        "	call Host_Exit\n");
+
+static char benchScene[BENCH_SCENE_SIZE];
+static int frameTimes[BENCH_MAX_FRAMES];
+static int aiTimes[BENCH_MAX_FRAMES];
+static int sortTimes[BENCH_MAX_FRAMES];
+
+/*
+================
+Bench_BuildScene
+
+Writes a mapfile with stacked dynamic props, the stacks fall onto
+the floor and settle, so a run covers both busy and resting frames
+================
+*/
+static int Bench_WeldId(int prop, int weldSize) { return MAX_GENTITIES - 1 - prop / weldSize; }
+
+static int Bench_BuildScene(int numProps, int numLayers, int weldSize) {
+	int i, side, perLayer, len = 0;
+	float x, y, z;
+	const char *weldKey;
+
+	perLayer = (numProps + numLayers - 1) / numLayers;
+	for(side = 1; side * side < perLayer; side++);
+
+	len += Q_snprintf(benchScene + len, BENCH_SCENE_SIZE - len, "//OpenSandbox Map File\n");
+	for(i = 0; i < numProps; i++) {
+		x = ((i % perLayer) % side - side / 2) * BENCH_PROP_SPACING;
+		y = ((i % perLayer) / side - side / 2) * BENCH_PROP_SPACING;
+		z = BENCH_PROP_SIZE + 1 + (i / perLayer) * (BENCH_PROP_SIZE * 2 + 4);
+
+		// group roots save their own old number, members the root's one
+		weldKey = NULL;
+		if(weldSize > 1) weldKey = (i % weldSize) ? "phys_welded" : "phys_parent";
+
+		len += Q_snprintf(benchScene + len, BENCH_SCENE_SIZE - len,
+		                  "{\n"
+		                  "   \"classname\"   \"sandbox_prop\"\n"
+		                  "   \"model\"   \"props/box.md3\"\n"
+		                  "   \"origin\"   \"%f %f %f\"\n"
+		                  "   \"modelscale_vec\"   \"1 1 1\"\n"
+		                  "   \"sb_class\"   \"none\"\n"
+		                  "   \"sb_coltype\"   \"%i\"\n"
+		                  "   \"sb_gravity\"   \"1\"\n"
+		                  "   \"sb_phys\"   \"%i\"\n"
+		                  "   \"sb_coll\"   \"%i\"\n",
+		                  x, y, z, BENCH_PROP_SIZE, PHYS_DYNAMIC, CONTENTS_SOLID);
+		iferr(len >= BENCH_SCENE_SIZE - 1);
+		if(weldKey) len += Q_snprintf(benchScene + len, BENCH_SCENE_SIZE - len, "   \"%s\"   \"%i\"\n", weldKey, Bench_WeldId(i, weldSize));
+		iferr(len >= BENCH_SCENE_SIZE - 1);
+		len += Q_snprintf(benchScene + len, BENCH_SCENE_SIZE - len, "}\n\n");
+		iferr(len >= BENCH_SCENE_SIZE - 1);
+	}
+
+	return len;
+}
+
+static int Bench_CompareInt(const void *a, const void *b) { return *(const int *)a - *(const int *)b; }
+
+static void Bench_Report(const char *name, const int *times, int count) {
+	int i;
+	double total = 0;
+
+	if(count <= 0) return;
+
+	for(i = 0; i < count; i++) {
+		sortTimes[i] = times[i];
+		total += times[i];
+	}
+	qsort(sortTimes, count, sizeof(sortTimes[0]), Bench_CompareInt);
+
+	print("%-8s avg %8.3f  min %8.3f  p50 %8.3f  p95 %8.3f  p99 %8.3f  max %8.3f ms\n", name, total / count / 1000.0, sortTimes[0] / 1000.0, sortTimes[count / 2] / 1000.0, sortTimes[count * 95 / 100] / 1000.0, sortTimes[count * 99 / 100] / 1000.0, sortTimes[count - 1] / 1000.0);
+}
+
+static void Bench_CountProps(int *awake, int *sleeping) {
+	int i;
+
+	*awake = *sleeping = 0;
+	for(i = MAX_CLIENTS; i < level.num_entities; i++) {
+		if(!g_entities[i].inuse || !g_entities[i].sandboxObject) continue;
+		if(g_entities[i].phys_sleeping) (*sleeping)++;
+		else (*awake)++;
+	}
+}
+
+/*
+================
+Bench_CheckWelds
+
+Every loaded member must hang off the root saved with the same old
+number, and every root must hold the rest of its group
+================
+*/
+static qboolean Bench_CheckWelds(int weldSize) {
+	int i, roots = 0, members = 0, bad = 0;
+	gentity_t *ent, *parent;
+
+	for(i = MAX_CLIENTS; i < level.num_entities; i++) {
+		ent = &g_entities[i];
+		if(!ent->inuse || !ent->sandboxObject) continue;
+
+		if(ent->phys_parent) {
+			roots++;
+			if(ent->physParentEnt || ent->phys_weldedObjectsNum != weldSize - 1) bad++;
+		} else if(ent->phys_welded) {
+			members++;
+			parent = ent->physParentEnt;
+			if(!parent || parent->phys_parent != ent->phys_welded || parent->physParentEnt) bad++;
+		}
+	}
+
+	print("welds    %i roots, %i members, %i broken\n", roots, members, bad);
+	return bad == 0 && roots > 0;
+}
+
+static int Bench_Command(const char *command) {
+	int start;
+
+	start = Host_Microseconds();
+	Bench_SetArgs(command);
+	vmMain(GAME_CONSOLE_COMMAND, 0, 0, 0);
+	return Host_Microseconds() - start;
+}
+
+/*
+================
+Bench_Reload
+
+Loads a save back, it must bring back every prop and weld
+================
+*/
+static qboolean Bench_Reload(const char *name, const char *command, int numProps, int weldSize) {
+	int msec, awake, sleeping;
+
+	msec = Bench_Command(command);
+	Bench_CountProps(&awake, &sleeping);
+	print("%-8s %i props in %.3f ms\n", name, awake + sleeping, msec / 1000.0);
+
+	if(awake + sleeping != numProps) {
+		print("FAILED: %s lost props\n", name);
+		return qfalse;
+	}
+	if(weldSize && !Bench_CheckWelds(weldSize)) {
+		print("FAILED: welds were not restored by %s\n", name);
+		return qfalse;
+	}
+	return qtrue;
+}
+
+/*
+================
+Bench_Overflow
+
+Loads more welded props than there are entities, the load has to stop
+at the limit and no weld may point at a freed slot, the world or a client
+================
+*/
+static qboolean Bench_Overflow(int numLayers, int weldSize) {
+	int i, numProps, msec, loaded = 0, bad = 0;
+	gentity_t *ent, *parent;
+
+	numProps = MAX_GENTITIES + MAX_GENTITIES / 4;
+	numProps -= numProps % weldSize;
+
+	// bench.add is not read again, so its buffer can hold the big scene
+	Bench_AddFile("maps/bench_big.add", benchScene, Bench_BuildScene(numProps, numLayers, weldSize));
+	msec = Bench_Command("loadmap maps/bench_big.add");
+
+	for(i = 0; i < MAX_GENTITIES; i++) {
+		ent = &g_entities[i];
+		if(!ent->inuse || !ent->sandboxObject) continue;
+
+		loaded++;
+		parent = ent->physParentEnt;
+		if(parent && (parent - g_entities < MAX_CLIENTS || !parent->inuse || !parent->sandboxObject)) bad++;
+	}
+
+	print("overflow %i of %i props in %.3f ms, %i bad welds\n", loaded, numProps, msec / 1000.0, bad);
+	if(level.num_entities > cvarInt("g_maxEntities") || loaded == 0 || loaded >= numProps || bad) {
+		print("FAILED: overflowing load\n");
+		return qfalse;
+	}
+	return qtrue;
+}
+
+static void Bench_RunFrames(int *levelTime, int msec, int count) {
+	for(; count > 0; count--) {
+		*levelTime += msec;
+		vmMain(GAME_RUN_FRAME, *levelTime, 0, 0);
+	}
+}
+
+/*
+================
+Bench_Vehicle
+
+A driven vehicle must stay awake, and must wake when the driver leaves
+because clients start extrapolating its fall right away. The driver is
+a bare client slot, it is never run as a player.
+================
+*/
+static qboolean Bench_Vehicle(int *levelTime, int msec) {
+	static char scene[512];
+	gentity_t *car, *driver;
+	qboolean parked, driven, left;
+	int i, frames;
+
+	Bench_AddFile("maps/bench_car.add", scene,
+	              Q_snprintf(scene, sizeof(scene),
+	                         "{\n"
+	                         "   \"classname\"   \"sandbox_prop\"\n"
+	                         "   \"model\"   \"props/box.md3\"\n"
+	                         "   \"origin\"   \"0 0 40\"\n"
+	                         "   \"modelscale_vec\"   \"1 1 1\"\n"
+	                         "   \"sb_class\"   \"none\"\n"
+	                         "   \"sb_gravity\"   \"1\"\n"
+	                         "   \"sb_phys\"   \"%i\"\n"
+	                         "   \"sb_coll\"   \"%i\"\n"
+	                         "   \"objectType\"   \"%i\"\n"
+	                         "   \"health\"   \"100\"\n"
+	                         "}\n",
+	                         PHYS_DYNAMIC, CONTENTS_SOLID, OT_VEHICLE));
+	Bench_Command("loadmap maps/bench_car.add");
+
+	car = NULL;
+	for(i = MAX_CLIENTS; i < level.num_entities; i++) {
+		if(g_entities[i].inuse && g_entities[i].objectType == OT_VEHICLE) car = &g_entities[i];
+	}
+	if(!car) {
+		print("FAILED: vehicle did not spawn\n");
+		return qfalse;
+	}
+
+	frames = PHYS_SLEEPTIME * 2 / msec + 2;
+	Bench_RunFrames(levelTime, msec, frames);
+	parked = car->phys_sleeping;
+
+	driver = &g_entities[0];
+	driver->client = &level.clients[0];
+	driver->health = 100;
+	G_Damage(car, driver, driver, NULL, NULL, 0, 0, WP_GAUNTLET);
+
+	driven = driver->client->vehicleNum == car->s.number;
+	for(i = 0; i < frames; i++) {
+		Bench_RunFrames(levelTime, msec, 1);
+		if(car->phys_sleeping) driven = qfalse;
+	}
+
+	driver->client->vehicleNum = 0;
+	Bench_RunFrames(levelTime, msec, 1);
+	left = car->think != Phys_VehiclePlayer && !car->phys_sleeping;
+
+	// once out it may only sleep again where it rests
+	Bench_RunFrames(levelTime, msec, frames);
+	if(car->phys_sleeping && car->s.pos.trType != TR_STATIONARY) left = qfalse;
+
+	memset(driver, 0, sizeof(*driver));
+
+	print("vehicle  parked %s, driven %s, left %s\n", parked ? "asleep" : "awake", driven ? "awake" : "asleep", left ? "simulated" : "frozen");
+	if(!parked || !driven || !left) {
+		print("FAILED: vehicle sleep\n");
+		return qfalse;
+	}
+	return qtrue;
+}
+
+static int Bench_ArgInt(int argc, char **argv, const char *name, int defaultValue) {
+	int i;
+
+	for(i = 1; i < argc - 1; i++) {
+		if(!Q_stricmp(argv[i], name)) return atoi(argv[i + 1]);
+	}
+	return defaultValue;
+}
+
+int Bench_Main(int argc, char **argv) {
+	int numProps, numLayers, numFrames, frameMsec, weldSize, autosave;
+	int i, len, levelTime, start, mid, end;
+	int awake, sleeping;
+	qboolean ok;
+
+	numProps = Bench_ArgInt(argc, argv, "-props", 1024);
+	numLayers = Bench_ArgInt(argc, argv, "-layers", 4);
+	numFrames = Bench_ArgInt(argc, argv, "-frames", 600);
+	frameMsec = Bench_ArgInt(argc, argv, "-msec", 50);
+	weldSize = Bench_ArgInt(argc, argv, "-weld", 0);
+	autosave = Bench_ArgInt(argc, argv, "-autosave", 0);
+
+	if(numProps < 1) numProps = 1;
+	if(numProps > MAX_GENTITIES - MAX_CLIENTS - 64) numProps = MAX_GENTITIES - MAX_CLIENTS - 64;
+	if(numLayers < 1) numLayers = 1;
+	if(numFrames < 1) numFrames = 1;
+	if(numFrames > BENCH_MAX_FRAMES) numFrames = BENCH_MAX_FRAMES;
+	if(frameMsec < 1) frameMsec = 1;
+	if(weldSize > numProps) weldSize = numProps;
+	if(weldSize > 1) numProps -= numProps % weldSize;
+	else weldSize = 0;
+
+	// server cvars the module expects the engine to provide
+	cvarSet("sv_mapname", "bench");
+	cvarSet("sv_cheats", "1");
+	cvarSet("g_gametype", "0");
+	cvarSet("g_maxEntities", va("%i", MAX_GENTITIES));
+	cvarSet("g_maxClients", "8");
+	cvarSet("g_gravity", "800");
+	cvarSet("g_jumpheight", "270");
+	cvarSet("g_speed", "320");
+	cvarSet("g_knockback", "1000");
+	cvarSet("g_dedicated", "1");
+	cvarSet("bot_enable", "0");
+	cvarSet("g_autosave", va("%i", autosave));
+	cvarSet("g_autosaveBudget", va("%i", Bench_ArgInt(argc, argv, "-budget", 2)));
+
+	len = Bench_BuildScene(numProps, numLayers, weldSize);
+	Bench_AddFile("maps/bench.add", benchScene, len);
+
+	levelTime = 0;
+	vmMain(GAME_INIT, levelTime, 0, qfalse);
+
+	start = Host_Microseconds();
+	Bench_SetArgs("loadmap maps/bench.add");
+	vmMain(GAME_CONSOLE_COMMAND, 0, 0, 0);
+	end = Host_Microseconds();
+	print("loadmap  %i props in %.3f ms\n", numProps, (end - start) / 1000.0);
+
+	if(weldSize && !Bench_CheckWelds(weldSize)) {
+		print("FAILED: welds were not restored\n");
+		vmMain(GAME_SHUTDOWN, qfalse, 0, 0);
+		return 1;
+	}
+
+	for(i = 0; i < numFrames; i++) {
+		levelTime += frameMsec;
+
+		start = Host_Microseconds();
+		vmMain(GAME_RUN_FRAME, levelTime, 0, 0);
+		mid = Host_Microseconds();
+		vmMain(BOTAI_START_FRAME, levelTime, 0, 0);
+		end = Host_Microseconds();
+
+		frameTimes[i] = mid - start;
+		aiTimes[i] = end - mid;
+	}
+
+	Bench_Report("frame", frameTimes, numFrames);
+	Bench_Report("ai", aiTimes, numFrames);
+
+	if(Bench_ArgInt(argc, argv, "-profile", 0)) Bench_Command("profile");
+
+	Bench_CountProps(&awake, &sleeping);
+	print("props    %i awake, %i sleeping after %i frames of %i msec\n", awake, sleeping, numFrames, frameMsec);
+
+	print("savemap  %.3f ms binary\n", Bench_Command("savemap maps/bench_out.add binary") / 1000.0);
+	print("savemap  %.3f ms text\n", Bench_Command("savemap maps/bench_text.add") / 1000.0);
+
+	ok = Bench_Reload("loadbin", "loadmap maps/bench_out.add", numProps, weldSize) && Bench_Reload("loadtext", "loadmap maps/bench_text.add", numProps, weldSize);
+	if(ok && autosave) ok = Bench_Reload("autosave", "loadautosave", numProps, weldSize);
+	if(ok && weldSize) ok = Bench_Overflow(numLayers, weldSize);
+	if(ok) ok = Bench_Vehicle(&levelTime, frameMsec);
+
+	vmMain(GAME_SHUTDOWN, qfalse, 0, 0);
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,612 @@
+// Copyright (C) 2023-2025 Noire.dev
+// OpenSandbox — GPLv2; see LICENSE for details.
+
+// Stub engine for the headless game benchmark. Everything the module
+// normally gets from the server is faked in memory: cvars, configstrings,
+// files, entity linking and a trace world made of a floor and entity boxes.
+
+#include "../shared/javascript.h"
+#include "bench_local.h"
+
+/*
+====================
+Host
+====================
+*/
+
+static int Host_Syscall3(int num, int a, int b, int c) {
+	int ret;
+	__asm__ volatile("int $0x80" : "=a"(ret) : "a"(num), "b"(a), "c"(b), "d"(c) : "memory");
+	return ret;
+}
+
+void Host_Write(const char *text) { Host_Syscall3(4, 1, (int)text, strlen(text)); }
+
+void Host_Exit(int code) {
+	Host_Syscall3(1, code, 0, 0);
+	while(1);
+}
+
+int Host_Microseconds(void) {
+	static int baseSec = -1;
+	int ts[2];
+
+	Host_Syscall3(265, 1, (int)ts, 0); // clock_gettime(CLOCK_MONOTONIC)
+	if(baseSec == -1) baseSec = ts[0];
+	return (ts[0] - baseSec) * 1000000 + ts[1] / 1000;
+}
+
+double sqrt(double x) {
+	__asm__("fsqrt" : "+t"(x));
+	return x;
+}
+
+double sin(double x) {
+	__asm__("fsin" : "+t"(x));
+	return x;
+}
+
+double cos(double x) {
+	__asm__("fcos" : "+t"(x));
+	return x;
+}
+
+double atan2(double y, double x) {
+	double r;
+	__asm__("fpatan" : "=t"(r) : "0"(x), "u"(y) : "st(1)");
+	return r;
+}
+
+double acos(double x) { return atan2(sqrt(1.0 - x * x), x); }
+
+void *memset(void *dest, int c, size_t count) {
+	char *d = dest;
+	while(count-- > 0) *d++ = c;
+	return dest;
+}
+
+void *memcpy(void *dest, const void *src, size_t count) {
+	char *d = dest;
+	const char *s = src;
+	while(count-- > 0) *d++ = *s++;
+	return dest;
+}
+
+char *strncpy(char *strDest, const char *strSource, size_t count) {
+	char *d = strDest;
+	while(count > 0 && *strSource) {
+		*d++ = *strSource++;
+		count--;
+	}
+	while(count-- > 0) *d++ = 0;
+	return strDest;
+}
+
+/*
+====================
+Shared syscalls
+====================
+*/
+
+#define BENCH_MAX_CVARS 1024
+#define BENCH_MAX_ARGS 16
+#define BENCH_MAX_FILES 16
+#define BENCH_FILE_POOL 0x2000000
+
+typedef struct {
+	char name[64];
+	char string[256];
+} benchCvar_t;
+
+typedef struct {
+	char name[MAX_QPATH];
+	char *data;
+	int len;
+	int size;
+} benchFile_t;
+
+typedef struct {
+	benchFile_t *file;
+	int pos;
+	fsMode_t mode;
+} benchHandle_t;
+
+static benchCvar_t benchCvars[BENCH_MAX_CVARS];
+static int benchNumCvars;
+
+static char benchArgs[BENCH_MAX_ARGS][MAX_TOKEN_CHARS];
+static int benchArgc;
+
+static benchFile_t benchFiles[BENCH_MAX_FILES];
+static int benchNumFiles;
+static benchHandle_t benchHandles[BENCH_MAX_FILES];
+static char benchFilePool[BENCH_FILE_POOL];
+static int benchFilePoolUsed;
+
+void trap_Print(const char *string) { Host_Write(string); }
+
+void trap_Error(const char *string) {
+	Host_Write(string);
+	Host_Write("\n");
+	Host_Exit(1);
+}
+
+int trap_Milliseconds(void) { return Host_Microseconds() / 1000; }
+
+int cvarID(const char *name) {
+	int i;
+
+	for(i = 0; i < benchNumCvars; i++) {
+		if(!Q_stricmp(benchCvars[i].name, name)) return i;
+	}
+
+	// unknown cvars read as empty, like unset engine cvars
+	iferr(benchNumCvars >= BENCH_MAX_CVARS);
+	StringCopy(benchCvars[benchNumCvars].name, name, sizeof(benchCvars[0].name));
+	benchCvars[benchNumCvars].string[0] = '\0';
+	return benchNumCvars++;
+}
+
+void cvarRegister(const char *name, const char *defaultValue, int flags) {
+	int id = cvarID(name);
+	if(!benchCvars[id].string[0]) StringCopy(benchCvars[id].string, defaultValue, sizeof(benchCvars[0].string));
+}
+
+void cvarUpdate(cvar_t *vmCvar, int cvarID) {
+	if(cvarID < 0 || cvarID >= benchNumCvars) return;
+	StringCopy(vmCvar->string, benchCvars[cvarID].string, sizeof(vmCvar->string));
+	vmCvar->value = atof(vmCvar->string);
+	vmCvar->integer = atoi(vmCvar->string);
+}
+
+void cvarReload(void) {}
+
+void cvarSet(const char *name, const char *value) { StringCopy(benchCvars[cvarID(name)].string, value, sizeof(benchCvars[0].string)); }
+
+void Bench_SetArgs(const char *text) {
+	int len;
+
+	benchArgc = 0;
+	while(*text && benchArgc < BENCH_MAX_ARGS) {
+		while(*text == ' ') text++;
+		if(!*text) break;
+		len = 0;
+		while(*text && *text != ' ' && len < MAX_TOKEN_CHARS - 1) benchArgs[benchArgc][len++] = *text++;
+		benchArgs[benchArgc++][len] = '\0';
+	}
+}
+
+int trap_Argc(void) { return benchArgc; }
+
+void trap_Argv(int n, char *buffer, int bufferLength) {
+	if(n < 0 || n >= benchArgc) {
+		buffer[0] = '\0';
+		return;
+	}
+	StringCopy(buffer, benchArgs[n], bufferLength);
+}
+
+void trap_Args(char *buffer, int bufferLength) {
+	int i;
+
+	buffer[0] = '\0';
+	for(i = 1; i < benchArgc; i++) {
+		if(i > 1) Q_strcat(buffer, bufferLength, " ");
+		Q_strcat(buffer, bufferLength, benchArgs[i]);
+	}
+}
+
+/*
+================
+Bench_AddFile
+
+Serves an in-memory file to FS_Open, the buffer must outlive the run
+================
+*/
+void Bench_AddFile(const char *name, char *data, int len) {
+	iferr(benchNumFiles >= BENCH_MAX_FILES);
+	StringCopy(benchFiles[benchNumFiles].name, name, sizeof(benchFiles[0].name));
+	benchFiles[benchNumFiles].data = data;
+	benchFiles[benchNumFiles].len = len;
+	benchFiles[benchNumFiles].size = len;
+	benchNumFiles++;
+}
+
+static benchFile_t *Bench_FindFile(const char *name) {
+	int i;
+
+	for(i = 0; i < benchNumFiles; i++) {
+		if(!Q_stricmp(benchFiles[i].name, name)) return &benchFiles[i];
+	}
+	return NULL;
+}
+
+int FS_Open(const char *qpath, fileHandle_t *f, fsMode_t mode) {
+	benchFile_t *file;
+	int i;
+
+	file = Bench_FindFile(qpath);
+
+	// a NULL handle only asks for the length
+	if(!f) return file ? file->len : -1;
+	*f = 0;
+
+	if(mode == FS_READ) {
+		if(!file) return -1;
+	} else if(!file) {
+		// writes go to a fresh slice of the pool, rewritten files keep their slice
+		if(benchNumFiles >= BENCH_MAX_FILES) return -1;
+		file = &benchFiles[benchNumFiles++];
+		StringCopy(file->name, qpath, sizeof(file->name));
+		file->size = (BENCH_FILE_POOL - benchFilePoolUsed) / 2;
+		file->data = benchFilePool + benchFilePoolUsed;
+		benchFilePoolUsed += file->size;
+		file->len = 0;
+	} else if(mode == FS_WRITE) {
+		file->len = 0;
+	}
+
+	for(i = 0; i < BENCH_MAX_FILES; i++) {
+		if(benchHandles[i].file) continue;
+		benchHandles[i].file = file;
+		benchHandles[i].mode = mode;
+		benchHandles[i].pos = mode == FS_READ ? 0 : file->len;
+		*f = i + 1;
+		return file->len;
+	}
+
+	return -1;
+}
+
+void FS_Read(void *buffer, int len, fileHandle_t f) {
+	benchHandle_t *h;
+
+	if(f < 1 || f > BENCH_MAX_FILES || !benchHandles[f - 1].file) return;
+	h = &benchHandles[f - 1];
+
+	if(len > h->file->len - h->pos) len = h->file->len - h->pos;
+	memcpy(buffer, h->file->data + h->pos, len);
+	h->pos += len;
+}
+
+void FS_Write(const void *buffer, int len, fileHandle_t f) {
+	benchHandle_t *h;
+
+	if(f < 1 || f > BENCH_MAX_FILES || !benchHandles[f - 1].file) return;
+	h = &benchHandles[f - 1];
+
+	if(len > h->file->size - h->pos) len = h->file->size - h->pos;
+	memcpy(h->file->data + h->pos, buffer, len);
+	h->pos += len;
+	if(h->pos > h->file->len) h->file->len = h->pos;
+}
+
+void FS_Close(fileHandle_t f) {
+	if(f < 1 || f > BENCH_MAX_FILES) return;
+	benchHandles[f - 1].file = NULL;
+}
+
+int FS_List(const char *path, const char *extension, char *listbuf, int bufsize) { return 0; }
+
+void trap_Cmd(int exec_when, const char *text) {}
+
+void trap_RealTime(qtime_t *qtime) { memset(qtime, 0, sizeof(*qtime)); }
+
+void trap_System(const char *command) {}
+
+void VMContext(js_args_t *args, js_result_t *result) {}
+qboolean JSOpenFile(const char *filename) { return qfalse; }
+void JSLoadScripts(const char *path, const char *name) {}
+qboolean JSEval(const char *code, js_result_t *result) { return qfalse; }
+qboolean JSCall(int id, js_args_t *args, js_result_t *result) { return qfalse; }
+
+/*
+====================
+Game syscalls
+====================
+*/
+
+#define BENCH_CONFIGSTRING_POOL 0x40000
+#define BENCH_FLOOR_SIZE 8192
+#define BENCH_FLOOR_DEPTH 64
+#define DIST_EPSILON 0.03125f
+
+static char *benchConfigstrings[MAX_CONFIGSTRINGS];
+static char benchConfigstringPool[BENCH_CONFIGSTRING_POOL];
+static int benchConfigstringPoolUsed;
+
+static byte *benchEntities;
+static int benchNumEntities;
+static int benchEntitySize;
+
+static const char *benchEntityTokens[] = {"{", "classname", "worldspawn", "}", NULL};
+static int benchEntityToken;
+
+#define BENCH_ENTITY(num) ((gentity_t *)(benchEntities + (num) * benchEntitySize))
+
+void trap_LocateGameData(gentity_t *gEnts, int numGEntities, int sizeofGEntity_t, playerState_t *gameClients, int sizeofGameClient) {
+	benchEntities = (byte *)gEnts;
+	benchNumEntities = numGEntities;
+	benchEntitySize = sizeofGEntity_t;
+}
+
+void trap_DropClient(int clientNum, const char *reason) {}
+
+void trap_SendServerCommand(int clientNum, const char *text) {}
+
+void trap_SetConfigstring(int num, const char *string) {
+	int len;
+
+	if(num < 0 || num >= MAX_CONFIGSTRINGS) err("trap_SetConfigstring: bad index");
+
+	if(benchConfigstrings[num] && !strcmp(benchConfigstrings[num], string)) return;
+
+	// the pool only grows, the benchmark never runs long enough to matter
+	len = strlen(string) + 1;
+	iferr(benchConfigstringPoolUsed + len > BENCH_CONFIGSTRING_POOL);
+	benchConfigstrings[num] = benchConfigstringPool + benchConfigstringPoolUsed;
+	memcpy(benchConfigstrings[num], string, len);
+	benchConfigstringPoolUsed += len;
+}
+
+void trap_GetConfigstring(int num, char *buffer, int bufferSize) {
+	if(num < 0 || num >= MAX_CONFIGSTRINGS || !benchConfigstrings[num]) {
+		buffer[0] = '\0';
+		return;
+	}
+	StringCopy(buffer, benchConfigstrings[num], bufferSize);
+}
+
+void trap_GetUserinfo(int num, char *buffer, int bufferSize) { buffer[0] = '\0'; }
+void trap_SetUserinfo(int num, const char *buffer) {}
+void trap_GetServerinfo(char *buffer, int bufferSize) { buffer[0] = '\0'; }
+
+void trap_SetBrushModel(gentity_t *ent, const char *name) {
+	ent->r.bmodel = qtrue;
+	VectorSet(ent->r.mins, -16, -16, -16);
+	VectorSet(ent->r.maxs, 16, 16, 16);
+}
+
+void trap_LinkEntity(gentity_t *ent) {
+	int i, j, k;
+
+	if(ent->r.bmodel) {
+		ent->s.solid = SOLID_BMODEL;
+	} else if(ent->r.contents & (CONTENTS_SOLID | CONTENTS_BODY)) {
+		i = ent->r.maxs[0];
+		if(i < 1) i = 1;
+		if(i > 255) i = 255;
+		j = -ent->r.mins[2];
+		if(j < 1) j = 1;
+		if(j > 255) j = 255;
+		k = ent->r.maxs[2] + 32;
+		if(k < 1) k = 1;
+		if(k > 255) k = 255;
+		ent->s.solid = (k << 16) | (j << 8) | i;
+	} else {
+		ent->s.solid = 0;
+	}
+
+	// rotation is ignored, boxes stay axial like the engine's encoded bboxes
+	for(i = 0; i < 3; i++) {
+		ent->r.absmin[i] = ent->r.currentOrigin[i] + ent->r.mins[i] - 1;
+		ent->r.absmax[i] = ent->r.currentOrigin[i] + ent->r.maxs[i] + 1;
+	}
+
+	ent->r.linked = qtrue;
+	ent->r.linkcount++;
+}
+
+void trap_UnlinkEntity(gentity_t *ent) { ent->r.linked = qfalse; }
+
+static qboolean Bench_BoxesTouch(const vec3_t mins1, const vec3_t maxs1, const vec3_t mins2, const vec3_t maxs2) {
+	return mins1[0] <= maxs2[0] && mins1[1] <= maxs2[1] && mins1[2] <= maxs2[2] && maxs1[0] >= mins2[0] && maxs1[1] >= mins2[1] && maxs1[2] >= mins2[2];
+}
+
+int trap_EntitiesInBox(const vec3_t mins, const vec3_t maxs, int *entityList, int maxcount) {
+	gentity_t *ent;
+	int i, count = 0;
+
+	for(i = 0; i < benchNumEntities && count < maxcount; i++) {
+		ent = BENCH_ENTITY(i);
+		if(!ent->r.linked) continue;
+		if(!Bench_BoxesTouch(mins, maxs, ent->r.absmin, ent->r.absmax)) continue;
+		entityList[count++] = i;
+	}
+
+	return count;
+}
+
+qboolean trap_EntityContact(const vec3_t mins, const vec3_t maxs, const gentity_t *ent) { return Bench_BoxesTouch(mins, maxs, ent->r.absmin, ent->r.absmax); }
+
+/*
+================
+Bench_ClipToBox
+
+Clips the move against one axial box that was already grown by the
+moving box, same plane walk as the engine's brush clipping
+================
+*/
+static void Bench_ClipToBox(trace_t *tr, const vec3_t start, const vec3_t end, const vec3_t mins, const vec3_t maxs, int entityNum, int contents) {
+	float enterFrac = -1, leaveFrac = 1;
+	float d1, d2, f;
+	qboolean getout = qfalse, startout = qfalse;
+	int i, side, leadAxis = -1, leadSide = 0;
+
+	for(i = 0; i < 3; i++) {
+		for(side = 0; side < 2; side++) {
+			if(side == 0) {
+				d1 = start[i] - maxs[i];
+				d2 = end[i] - maxs[i];
+			} else {
+				d1 = mins[i] - start[i];
+				d2 = mins[i] - end[i];
+			}
+
+			if(d2 > 0) getout = qtrue;
+			if(d1 > 0) startout = qtrue;
+
+			// completely in front of this face
+			if(d1 > 0 && (d2 >= DIST_EPSILON || d2 >= d1)) return;
+			if(d1 <= 0 && d2 <= 0) continue;
+
+			if(d1 > d2) {
+				f = (d1 - DIST_EPSILON) / (d1 - d2);
+				if(f < 0) f = 0;
+				if(f > enterFrac) {
+					enterFrac = f;
+					leadAxis = i;
+					leadSide = side;
+				}
+			} else {
+				f = (d1 + DIST_EPSILON) / (d1 - d2);
+				if(f > 1) f = 1;
+				if(f < leaveFrac) leaveFrac = f;
+			}
+		}
+	}
+
+	if(!startout) {
+		tr->startsolid = qtrue;
+		if(!getout) {
+			tr->allsolid = qtrue;
+			tr->fraction = 0;
+			tr->contents = contents;
+			tr->entityNum = entityNum;
+		}
+		return;
+	}
+
+	if(enterFrac < leaveFrac && enterFrac > -1 && enterFrac < tr->fraction) {
+		if(enterFrac < 0) enterFrac = 0;
+		tr->fraction = enterFrac;
+		VectorClear(tr->plane.normal);
+		tr->plane.normal[leadAxis] = leadSide == 0 ? 1 : -1;
+		tr->plane.dist = leadSide == 0 ? maxs[leadAxis] : -mins[leadAxis];
+		tr->plane.type = leadAxis;
+		tr->contents = contents;
+		tr->entityNum = entityNum;
+	}
+}
+
+static qboolean Bench_SkipEntity(gentity_t *ent, int passEntityNum) {
+	gentity_t *pass;
+
+	if(passEntityNum == ENTITYNUM_NONE) return qfalse;
+	if(ent->s.number == passEntityNum) return qtrue;
+	if(ent->r.ownerNum == passEntityNum) return qtrue;
+
+	pass = BENCH_ENTITY(passEntityNum);
+	if(pass->r.ownerNum == ent->s.number) return qtrue;
+	if(pass->r.ownerNum != ENTITYNUM_NONE && pass->r.ownerNum == ent->r.ownerNum) return qtrue;
+
+	return qfalse;
+}
+
+void trap_Trace(trace_t *results, const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, int passEntityNum, int contentmask) {
+	vec3_t boxMins, boxMaxs;
+	vec3_t traceMins, traceMaxs;
+	gentity_t *ent;
+	int i, j;
+
+	if(!mins) mins = vec3_origin;
+	if(!maxs) maxs = vec3_origin;
+
+	memset(results, 0, sizeof(*results));
+	results->fraction = 1;
+	results->entityNum = ENTITYNUM_NONE;
+
+	for(i = 0; i < 3; i++) {
+		traceMins[i] = (start[i] < end[i] ? start[i] : end[i]) + mins[i] - 1;
+		traceMaxs[i] = (start[i] > end[i] ? start[i] : end[i]) + maxs[i] + 1;
+	}
+
+	// the world is a single floor slab under the origin
+	if(contentmask & CONTENTS_SOLID) {
+		VectorSet(boxMins, -BENCH_FLOOR_SIZE - maxs[0], -BENCH_FLOOR_SIZE - maxs[1], -BENCH_FLOOR_DEPTH - maxs[2]);
+		VectorSet(boxMaxs, BENCH_FLOOR_SIZE - mins[0], BENCH_FLOOR_SIZE - mins[1], -mins[2]);
+		Bench_ClipToBox(results, start, end, boxMins, boxMaxs, ENTITYNUM_WORLD, CONTENTS_SOLID);
+	}
+
+	for(i = 0; i < benchNumEntities && !results->allsolid; i++) {
+		ent = BENCH_ENTITY(i);
+		if(!ent->r.linked || !(ent->r.contents & contentmask)) continue;
+		if(!Bench_BoxesTouch(traceMins, traceMaxs, ent->r.absmin, ent->r.absmax)) continue;
+		if(Bench_SkipEntity(ent, passEntityNum)) continue;
+
+		for(j = 0; j < 3; j++) {
+			boxMins[j] = ent->r.currentOrigin[j] + ent->r.mins[j] - maxs[j];
+			boxMaxs[j] = ent->r.currentOrigin[j] + ent->r.maxs[j] - mins[j];
+		}
+		Bench_ClipToBox(results, start, end, boxMins, boxMaxs, i, ent->r.contents);
+	}
+
+	for(i = 0; i < 3; i++) {
+		results->endpos[i] = start[i] + results->fraction * (end[i] - start[i]);
+	}
+}
+
+int trap_PointContents(const vec3_t point, int passEntityNum) {
+	gentity_t *ent;
+	int i, contents = 0;
+
+	if(point[0] >= -BENCH_FLOOR_SIZE && point[0] <= BENCH_FLOOR_SIZE && point[1] >= -BENCH_FLOOR_SIZE && point[1] <= BENCH_FLOOR_SIZE && point[2] >= -BENCH_FLOOR_DEPTH && point[2] <= 0) contents |= CONTENTS_SOLID;
+
+	for(i = 0; i < benchNumEntities; i++) {
+		ent = BENCH_ENTITY(i);
+		if(!ent->r.linked || i == passEntityNum) continue;
+		if(!Bench_BoxesTouch(point, point, ent->r.absmin, ent->r.absmax)) continue;
+		contents |= ent->r.contents;
+	}
+
+	return contents;
+}
+
+qboolean trap_InPVS(const vec3_t p1, const vec3_t p2) { return qtrue; }
+
+void trap_AdjustAreaPortalState(gentity_t *ent, qboolean open) {}
+
+int trap_BotAllocateClient(void) { return -1; }
+
+void trap_GetUsercmd(int clientNum, usercmd_t *cmd) { memset(cmd, 0, sizeof(*cmd)); }
+
+qboolean trap_GetEntityToken(char *buffer, int bufferSize) {
+	if(!benchEntityTokens[benchEntityToken]) {
+		benchEntityToken = 0;
+		return qfalse;
+	}
+	StringCopy(buffer, benchEntityTokens[benchEntityToken++], bufferSize);
+	return qtrue;
+}
+
+/*
+====================
+Botlib
+
+No AAS data is loaded, every query reports an empty world
+====================
+*/
+
+int trap_BotLibSetup(void) { return 0; }
+int trap_BotLibShutdown(void) { return 0; }
+int trap_BotLibStartFrame(float time) { return 0; }
+int trap_BotLibLoadMap(const char *mapname) { return 0; }
+int trap_BotGetServerCommand(int clientNum, char *message, int size) { return 0; }
+void trap_BotUserCommand(int client, usercmd_t *ucmd) {}
+int trap_BotUpdateEntity(int ent, void *bue) { return 0; }
+int trap_AAS_Initialized(void) { return 0; }
+float trap_AAS_Time(void) { return 0; }
+int trap_AAS_PointAreaNum(vec3_t point) { return 0; }
+int trap_AAS_TraceAreas(vec3_t start, vec3_t end, int *areas, vec3_t *points, int maxareas) { return 0; }
+void trap_EA_Command(int client, char *command) {}
+void trap_EA_Gesture(int client) {}
+void trap_EA_Attack(int client) {}
+void trap_EA_Use(int client) {}
+void trap_EA_View(int client, vec3_t viewangles) {}
+void trap_EA_GetInput(int client, float thinktime, void *input) { memset(input, 0, sizeof(bot_input_t)); }
+void trap_EA_ResetInput(int client) {}
+void trap_BotMoveToGoal(int movestate, void *goal, int travelflags) {}
+void trap_BotResetMoveState(int movestate) {}
+int trap_BotAllocMoveState(void) { return 0; }
+void trap_BotFreeMoveState(int handle) {}
+void trap_BotInitMoveState(int handle, void *initmove) {}
@@ -4,12 +4,30 @@
 
 #include "../shared/javascript.h"
 
+#define STRINGS3D_BUDGET 64 // strings drawn per frame when cg_3dStringBudget is not positive
+#define STRINGS3D_TRACES 16 // occlusion traces per frame when cg_3dStringTraces is not positive
+#define STRINGS3D_MARGIN 128 // offscreen distance a centered string can still reach the screen from
+
+typedef struct {
+	queued3DString_t *q;
+	float x, y;
+	float dist;
+} visible3DString_t;
+
 static queued3DString_t queued3DStrings[MAX_3D_STRING_QUEUE];
 static int queued3DStringCount = 0;
+static int queued3DStringDropped = 0;
+static visible3DString_t visible3DStrings[MAX_3D_STRING_QUEUE];
+
 void CG_Add3DString(float x, float y, float z, const char *str, int style, const vec4_t color, float fontSize, float min, float max, qboolean useTrace) {
-	queued3DString_t *q = &queued3DStrings[queued3DStringCount++];
+	queued3DString_t *q;
 
-	if(queued3DStringCount >= MAX_3D_STRING_QUEUE) return;
+	if(queued3DStringCount >= MAX_3D_STRING_QUEUE) {
+		if(!queued3DStringDropped++) print("^3CG_Add3DString: queue full, dropping strings\n");
+		return;
+	}
+
+	q = &queued3DStrings[queued3DStringCount++];
 	q->x = x;
 	q->y = y;
 	q->z = z;
@@ -22,13 +40,98 @@ void CG_Add3DString(float x, float y, float z, const char *str, int style, const
 	q->useTrace = useTrace;
 }
 
+static int QDECL CG_Compare3DStrings(const void *a, const void *b) {
+	const visible3DString_t *va = a, *vb = b;
+
+	if(va->dist < vb->dist) return -1;
+	if(va->dist > vb->dist) return 1;
+	return 0;
+}
+
+/*
+=================
+CG_Draw3DStringQueue
+
+Strings behind the view, off the screen or faded out by distance are
+dropped first. The nearest ones are then traced and drawn within the
+cg_3dStringBudget and cg_3dStringTraces limits, farthest first so the
+near ones end up on top.
+=================
+*/
 static void CG_Draw3DStringQueue(void) {
-	int i;
+	queued3DString_t *q;
+	visible3DString_t *v;
+	vec3_t worldPos, dir;
+	vec4_t color;
+	float tanFovX, tanFovY;
+	float localX, localY, localZ;
+	float halfWidth;
+	int i, numVisible, numDrawn, budget, traces;
+	trace_t trace;
+
+	if(!queued3DStringCount) return;
+
+	tanFovX = tan(DEG2RAD(cg.refdef.fov_x * 0.5f));
+	tanFovY = tan(DEG2RAD(cg.refdef.fov_y * 0.5f));
+	halfWidth = 320 + cgui.wideoffset;
+
+	numVisible = 0;
 	for(i = 0; i < queued3DStringCount; i++) {
-		queued3DString_t *q = &queued3DStrings[i];
-		CG_Draw3DString(q->x, q->y, q->z, q->str, q->style, q->color, q->fontSize, q->min, q->max, q->useTrace);
+		q = &queued3DStrings[i];
+		v = &visible3DStrings[numVisible];
+
+		VectorSet(worldPos, q->x, q->y, q->z);
+		VectorSubtract(worldPos, cg.refdef.vieworg, dir);
+
+		localZ = DotProduct(dir, cg.refdef.viewaxis[0]);
+		if(localZ <= 0) continue;
+
+		v->dist = VectorLength(dir);
+		if(v->dist > q->min && v->dist >= q->max) continue;
+
+		localX = -DotProduct(dir, cg.refdef.viewaxis[1]);
+		localY = DotProduct(dir, cg.refdef.viewaxis[2]);
+		v->x = (localX / (localZ * tanFovX)) * halfWidth + 320;
+		v->y = (-localY / (localZ * tanFovY)) * 240 + 240;
+		if(v->x < 320 - halfWidth - STRINGS3D_MARGIN || v->x > 320 + halfWidth + STRINGS3D_MARGIN) continue;
+		if(v->y < -STRINGS3D_MARGIN || v->y > 480 + STRINGS3D_MARGIN) continue;
+
+		v->q = q;
+		numVisible++;
 	}
 	queued3DStringCount = 0;
+
+	qsort(visible3DStrings, numVisible, sizeof(visible3DStrings[0]), CG_Compare3DStrings);
+
+	budget = cvarTrackedInt(cg_3dStringBudget);
+	if(budget <= 0) budget = STRINGS3D_BUDGET;
+	traces = cvarTrackedInt(cg_3dStringTraces);
+	if(traces <= 0) traces = STRINGS3D_TRACES;
+
+	// pick the nearest strings that pass the occlusion trace
+	numDrawn = 0;
+	for(i = 0; i < numVisible && numDrawn < budget; i++) {
+		q = visible3DStrings[i].q;
+		if(q->useTrace) {
+			// without a trace the string could show through a wall
+			if(!traces) continue;
+			traces--;
+			VectorSet(worldPos, q->x, q->y, q->z);
+			CG_Trace(&trace, cg.refdef.vieworg, vec3_origin, vec3_origin, worldPos, cg.snap->ps.clientNum, CONTENTS_SOLID);
+			if(trace.fraction < 1.0f) continue;
+		}
+		visible3DStrings[numDrawn++] = visible3DStrings[i];
+	}
+
+	for(i = numDrawn - 1; i >= 0; i--) {
+		v = &visible3DStrings[i];
+		q = v->q;
+
+		Vector4Copy(q->color, color);
+		if(v->dist > q->min) color[3] = q->color[3] * (1.0f - (v->dist - q->min) / (q->max - q->min));
+
+		ST_DrawString(v->x, v->y, q->str, q->style | UI_CENTER, color, q->fontSize);
+	}
 }
 
 static void CG_Draw3DModelToolgun(float x, float y, float w, float h, qhandle_t model, char *texlocation, char *material) {
@@ -5,8 +5,10 @@
 #include "../shared/javascript.h"
 
 void CG_BubbleTrail(vec3_t start, vec3_t end, float spacing) {
+	static const byte white[4] = {0xff, 0xff, 0xff, 0xff};
 	vec3_t move;
 	vec3_t vec;
+	vec3_t velocity;
 	float len;
 	int i;
 
@@ -21,36 +23,10 @@ void CG_BubbleTrail(vec3_t start, vec3_t end, float spacing) {
 	VectorScale(vec, spacing, vec);
 
 	for(; i < len; i += spacing) {
-		localEntity_t *le;
-		refEntity_t *re;
-
-		le = CG_AllocLocalEntity();
-		le->leFlags = LEF_PUFF_DONT_SCALE;
-		le->leType = LE_MOVE_SCALE_FADE;
-		le->startTime = cg.time;
-		le->endTime = cg.time + 1000 + random() * 250;
-		le->lifeRate = 1.0 / (le->endTime - le->startTime);
-
-		re = &le->refEntity;
-		re->shaderTime = cg.time / 1000.0f;
-
-		re->reType = RT_SPRITE;
-		re->rotation = 0;
-		re->radius = 3;
-		re->customShader = cgs.media.waterBubbleShader;
-		re->shaderRGBA[0] = 0xff;
-		re->shaderRGBA[1] = 0xff;
-		re->shaderRGBA[2] = 0xff;
-		re->shaderRGBA[3] = 0xff;
-
-		le->color[3] = 1.0;
-
-		le->pos.trType = TR_LINEAR;
-		le->pos.trTime = cg.time;
-		VectorCopy(move, le->pos.trBase);
-		le->pos.trDelta[0] = crandom() * 5;
-		le->pos.trDelta[1] = crandom() * 5;
-		le->pos.trDelta[2] = crandom() * 5 + 6;
+		velocity[0] = crandom() * 5;
+		velocity[1] = crandom() * 5;
+		velocity[2] = crandom() * 5 + 6;
+		CG_SpawnParticle(move, velocity, qfalse, 1000 + random() * 250, 3, cgs.media.waterBubbleShader, white);
 
 		VectorAdd(move, vec, move);
 	}
@@ -324,40 +300,16 @@ static void CG_Particles(vec3_t origin, int count, int speed, int lifetime, int
 	int index;
 	vec3_t randVec, tempVec;
 	qboolean moveUp;
+	byte color[4];
 
 	jump = speed;
 	shader = cgs.media.sparkShader;
+	color[0] = r;
+	color[1] = g;
+	color[2] = b;
+	color[3] = 0xff;
 
 	for(index = 0; index < count; index++) {
-		localEntity_t *le;
-		refEntity_t *re;
-
-		le = CG_AllocLocalEntity(); // allocate a local entity
-		re = &le->refEntity;
-		le->leFlags = LEF_PUFF_DONT_SCALE;                              // don't change the particle size
-		le->leType = LE_MOVE_SCALE_FADE;                                // particle should fade over time
-		le->startTime = cg.time;                                        // set the start time of the particle to the current time
-		le->endTime = cg.time + lifetime + (random() * (lifetime / 2)); // life time will be anywhere between [lifetime] and [lifetime * 1.5]
-		le->lifeRate = 1.0 / (le->endTime - le->startTime);
-		re = &le->refEntity;
-		re->shaderTime = cg.time / 1000.0f;
-		re->reType = RT_SPRITE;
-		re->rotation = 0;
-		re->radius = radius;
-		re->customShader = shader;
-		re->shaderRGBA[0] = r;
-		re->shaderRGBA[1] = g;
-		re->shaderRGBA[2] = b;
-		re->shaderRGBA[3] = 0xFF;
-		le->color[3] = 1.0;
-		if(type == PT_GRAVITY)
-			le->pos.trType = TR_GRAVITY; // moves in a gravity affected arc
-		else
-			le->pos.trType = TR_LINEAR; // moves in straight line, outward from the origin
-		le->pos.trTime = cg.time;
-		VectorCopy(origin, le->pos.trBase);
-		VectorCopy(origin, re->origin);
-
 		tempVec[0] = crandom(); // between 1 and -1
 		tempVec[1] = crandom();
 		tempVec[2] = crandom();
@@ -378,7 +330,9 @@ static void CG_Particles(vec3_t origin, int count, int speed, int lifetime, int
 		else
 			randVec[2] -= jump; // nudge the particles down a bit
 
-		VectorCopy(randVec, le->pos.trDelta);
+		// life time will be anywhere between [lifetime] and [lifetime * 1.5],
+		// PT_GRAVITY moves in an arc, the others in a straight line outward
+		CG_SpawnParticle(origin, randVec, type == PT_GRAVITY, lifetime + random() * (lifetime / 2), radius, shader, color);
 	}
 }
 
@@ -80,6 +80,54 @@ static void CG_EntityEffects(centity_t *cent) {
 	}
 }
 
+#define MATERIAL_CACHE_SIZE 1024
+#define MATERIAL_CACHE_PROBES 8
+
+typedef struct {
+	int modelIndex; // 0 when the slot is empty
+	int material;
+	qhandle_t skin;
+	qhandle_t shader;
+} materialCache_t;
+
+static materialCache_t materialCache[MATERIAL_CACHE_SIZE];
+
+/*
+==================
+CG_ClearMaterialCache
+
+Called when a model configstring changes
+==================
+*/
+void CG_ClearMaterialCache(void) { memset(materialCache, 0, sizeof(materialCache)); }
+
+/*
+==================
+CG_MaterialHandles
+
+Skin and shader for a model and material, registered on first use only
+==================
+*/
+static materialCache_t *CG_MaterialHandles(int modelIndex, int material) {
+	materialCache_t *mc;
+	int hash = (modelIndex * 31 + material) & (MATERIAL_CACHE_SIZE - 1);
+	int i;
+
+	for(i = 0; i < MATERIAL_CACHE_PROBES; i++) {
+		mc = &materialCache[(hash + i) & (MATERIAL_CACHE_SIZE - 1)];
+		if(!mc->modelIndex) break;
+		if(mc->modelIndex == modelIndex && mc->material == material) return mc;
+	}
+	if(i == MATERIAL_CACHE_PROBES) mc = &materialCache[hash]; // evict the home slot
+
+	mc->modelIndex = modelIndex;
+	mc->material = material;
+	mc->skin = trap_R_RegisterSkin(va("mtr/%s/%i.skin", CG_ConfigString(CS_MODELS + modelIndex), material));
+	mc->shader = 0;
+	if(material > 0) mc->shader = trap_R_RegisterShader(va("mtr/%s/%i", CG_ConfigString(CS_MODELS + modelIndex), material));
+	return mc;
+}
+
 static void CG_General(centity_t *cent) {
 	refEntity_t ent;
 	centity_t *weldroot;
@@ -87,8 +135,8 @@ static void CG_General(centity_t *cent) {
 	refEntity_t wheelfl;
 	refEntity_t wheelrr;
 	refEntity_t wheelrl;
-	char str[MAX_QPATH];
 	entityState_t *s1;
+	materialCache_t *mc;
 	int cl;
 	int r, g, b;
 
@@ -118,18 +166,9 @@ static void CG_General(centity_t *cent) {
 		ent.hModel = cgs.gameModels[s1->modelindex2];
 	}
 	ent.reType = RT_MODEL;
-	if(!s1->modelindex2) {
-		ent.customSkin = trap_R_RegisterSkin(va("mtr/%s/%i.skin", CG_ConfigString(CS_MODELS + s1->modelindex), s1->generic2));
-	} else {
-		ent.customSkin = trap_R_RegisterSkin(va("mtr/%s/%i.skin", CG_ConfigString(CS_MODELS + s1->modelindex2), s1->generic2));
-	}
-	if(s1->generic2 > 0) {
-		if(!s1->modelindex2) {
-			ent.customShader = trap_R_RegisterShader(va("mtr/%s/%i", CG_ConfigString(CS_MODELS + s1->modelindex), s1->generic2));
-		} else {
-			ent.customShader = trap_R_RegisterShader(va("mtr/%s/%i", CG_ConfigString(CS_MODELS + s1->modelindex2), s1->generic2));
-		}
-	}
+	mc = CG_MaterialHandles(s1->modelindex2 ? s1->modelindex2 : s1->modelindex, s1->generic2);
+	ent.customSkin = mc->skin;
+	ent.customShader = mc->shader;
 	if(s1->generic2 == 255) {
 		if(cg.snap->ps.weapon == WP_PHYSGUN || cg.snap->ps.weapon == WP_GRAVITYGUN || cg.snap->ps.weapon == WP_TOOLGUN) {
 			ent.customShader = cgs.media.ptexShader[1];
@@ -147,12 +186,6 @@ static void CG_General(centity_t *cent) {
 	ent.shaderRGBA[2] = b;
 	ent.shaderRGBA[3] = 255;
 
-	if(!s1->modelindex2) {
-		Com_sprintf(str, sizeof(str), CG_ConfigString(CS_MODELS + s1->modelindex));
-	} else {
-		Com_sprintf(str, sizeof(str), CG_ConfigString(CS_MODELS + s1->modelindex2));
-	}
-
 	// Weld sync
 	if(s1->otherEntityNum) {
 		vec3_t forward, right, up;
@@ -221,7 +254,7 @@ static void CG_General(centity_t *cent) {
 		VectorCopy(cent->lerpOrigin, wheelfr.origin);
 		VectorCopy(cent->lerpOrigin, wheelfr.oldorigin);
 
-		wheelfr.hModel = trap_R_RegisterModel("models/v_wheel");
+		wheelfr.hModel = cgs.media.wheelModel;
 		wheelfr.customSkin = ent.customSkin;
 		wheelfr.customShader = ent.customShader;
 		wheelfr.reType = RT_MODEL;
@@ -241,7 +274,7 @@ static void CG_General(centity_t *cent) {
 		VectorCopy(cent->lerpOrigin, wheelfl.origin);
 		VectorCopy(cent->lerpOrigin, wheelfl.oldorigin);
 
-		wheelfl.hModel = trap_R_RegisterModel("models/v_wheel");
+		wheelfl.hModel = cgs.media.wheelModel;
 		wheelfl.customSkin = ent.customSkin;
 		wheelfl.customShader = ent.customShader;
 		wheelfl.reType = RT_MODEL;
@@ -261,7 +294,7 @@ static void CG_General(centity_t *cent) {
 		VectorCopy(cent->lerpOrigin, wheelrr.origin);
 		VectorCopy(cent->lerpOrigin, wheelrr.oldorigin);
 
-		wheelrr.hModel = trap_R_RegisterModel("models/v_wheel");
+		wheelrr.hModel = cgs.media.wheelModel;
 		wheelrr.customSkin = ent.customSkin;
 		wheelrr.customShader = ent.customShader;
 		wheelrr.reType = RT_MODEL;
@@ -281,7 +314,7 @@ static void CG_General(centity_t *cent) {
 		VectorCopy(cent->lerpOrigin, wheelrl.origin);
 		VectorCopy(cent->lerpOrigin, wheelrl.oldorigin);
 
-		wheelrl.hModel = trap_R_RegisterModel("models/v_wheel");
+		wheelrl.hModel = cgs.media.wheelModel;
 		wheelrl.customSkin = ent.customSkin;
 		wheelrl.customShader = ent.customShader;
 		wheelrl.reType = RT_MODEL;
@@ -20,7 +20,8 @@
 #define MAX_STEP_CHANGE 32
 
 #define MAX_VERTS_ON_POLY 128 * 1
-#define MAX_MARK_POLYS 1024 * 8
+#define MAX_MARK_POLYS 1024 * 16
+#define MAX_MARK_VERTS 1024 * 128 // shared by all mark polys
 
 #define ICON_SIZE 16
 
@@ -135,8 +136,8 @@ typedef struct markPoly_s {
 	qhandle_t markShader;
 	qboolean alphaFade; // fade alpha instead of rgb
 	float color[4];
-	poly_t poly;
-	polyVert_t verts[MAX_VERTS_ON_POLY];
+	int numVerts;
+	polyVert_t *verts; // in the mark vertex ring
 } markPoly_t;
 
 typedef enum { LE_EXPLOSION, LE_SPRITE_EXPLOSION, LE_FRAGMENT, LE_FRAGMENT2, LE_MOVE_SCALE_FADE, LE_FALL_SCALE_FADE, LE_FADE_RGB, LE_SCALE_FADE, LE_SHOWREFENTITY } leType_t;
@@ -512,6 +513,7 @@ typedef struct {
 	sfxHandle_t useNothingSound;
 	sfxHandle_t footsteps[FOOTSTEP_TOTAL][4];
 	sfxHandle_t carengine[11];
+	qhandle_t wheelModel;
 	sfxHandle_t sfx_lghit1;
 	sfxHandle_t sfx_lghit2;
 	sfxHandle_t sfx_lghit3;
@@ -650,6 +652,13 @@ extern markPoly_t cg_markPolys[MAX_MARK_POLYS];
 extern int mod_jumpheight;
 extern int mod_gravity;
 
+extern cvarHandle_t cg_addMarks;
+extern cvarHandle_t cg_effectsTime;
+extern cvarHandle_t cg_thirdPerson;
+extern cvarHandle_t cg_cameraEyes;
+extern cvarHandle_t cg_3dStringBudget;
+extern cvarHandle_t cg_3dStringTraces;
+
 // cg_consolecmds.c
 qboolean CG_ConsoleCommand(void);
 void CG_InitConsoleCommands(void);
@@ -664,7 +673,6 @@ void CG_DrawActive(void);
 // cg_drawtools.c
 void CG_DrawProgressBar(float x, float y, float width, float height, float progress, float segmentWidth, const float *barColor, const float *bgColor);
 void CG_DrawPic(float x, float y, float width, float height, qhandle_t hShader);
-void CG_Draw3DString(float x, float y, float z, const char *str, int style, vec4_t color, float fontSize, float min, float max, qboolean useTrace);
 float *CG_FadeColor(int startMsec, int totalMsec);
 
 // cg_effects.c
@@ -678,6 +686,7 @@ void CG_GibPlayer(vec3_t playerOrigin);
 void CG_ParticlesFromEntityState(vec3_t origin, int type, entityState_t *es);
 
 // cg_ents.c
+void CG_ClearMaterialCache(void);
 void CG_PositionRotatedEntityOnTag(refEntity_t *entity, const refEntity_t *parent, qhandle_t parentModel, char *tagName);
 void CG_SetEntitySoundPosition(centity_t *cent);
 void CG_AddPacketEntities(void);
@@ -707,6 +716,11 @@ void CG_InitMarkPolys(void);
 void CG_ImpactMark(qhandle_t markShader, const vec3_t origin, const vec3_t dir, float orientation, float red, float green, float blue, float alpha, qboolean alphaFade, float radius, qboolean temporary);
 void CG_AddMarks(void);
 
+// cg_particles.c
+void CG_InitParticles(void);
+void CG_SpawnParticle(const vec3_t origin, const vec3_t velocity, qboolean gravity, int lifetime, float radius, qhandle_t shader, const byte *color);
+void CG_AddParticles(void);
+
 // cg_players.c
 void CG_UpdateClientInfo(int clientNum);
 void CG_Player(centity_t *cent);
@@ -40,6 +40,13 @@ itemInfo_t cg_items[MAX_ITEMS];
 int mod_jumpheight;
 int mod_gravity;
 
+cvarHandle_t cg_addMarks;
+cvarHandle_t cg_effectsTime;
+cvarHandle_t cg_thirdPerson;
+cvarHandle_t cg_cameraEyes;
+cvarHandle_t cg_3dStringBudget;
+cvarHandle_t cg_3dStringTraces;
+
 static void CG_CreateCvars(void) {
 	cgs.localServer = cvarInt("sv_running");
 
@@ -49,6 +56,15 @@ static void CG_CreateCvars(void) {
 	cvarRegister("team_model", "beret/default", CVAR_USERINFO | CVAR_ARCHIVE);
 	cvarRegister("team_headmodel", "beret/default", CVAR_USERINFO | CVAR_ARCHIVE);
 	cvarRegister("team_legsmodel", "beret/default", CVAR_USERINFO | CVAR_ARCHIVE);
+	cvarRegister("cg_3dStringBudget", "64", CVAR_ARCHIVE);
+	cvarRegister("cg_3dStringTraces", "16", CVAR_ARCHIVE);
+
+	cg_addMarks = cvarTrack("cg_addMarks");
+	cg_effectsTime = cvarTrack("cg_effectsTime");
+	cg_thirdPerson = cvarTrack("cg_thirdPerson");
+	cg_cameraEyes = cvarTrack("cg_cameraEyes");
+	cg_3dStringBudget = cvarTrack("cg_3dStringBudget");
+	cg_3dStringTraces = cvarTrack("cg_3dStringTraces");
 }
 
 void QDECL CG_PrintfChat(qboolean team, const char *msg, ...) {
@@ -233,6 +249,8 @@ static void CG_RegisterGraphics(void) {
 	cgs.media.ptexShader[0] = trap_R_RegisterShader("trans");
 	cgs.media.ptexShader[1] = trap_R_RegisterShader("powerups/quad");
 
+	cgs.media.wheelModel = trap_R_RegisterModel("models/v_wheel");
+
 	cgs.media.dustPuffShader = trap_R_RegisterShader("hasteSmokePuff");
 
 	if(cgs.gametype >= GT_TEAM) {
@@ -407,6 +425,7 @@ static void CG_Init(int serverMessageNum, int serverCommandSequence, int clientN
 	CG_LoadingString("entities", 0.90);
 	CG_InitLocalEntities();
 	CG_InitMarkPolys();
+	CG_InitParticles();
 
 	// Make sure we have update values (scores)
 	CG_SetConfigValues();
@@ -420,6 +439,9 @@ static void CG_Init(int serverMessageNum, int serverCommandSequence, int clientN
 
 	trap_Cmd(EXEC_INSERT, "exec scripts/tools/create.cfg\n");
 	trap_Cmd(EXEC_INSERT, va("weapon %i\n", WP_TOOLGUN));
+
+	// fresh cgame holds no sweps or game cvars, ask for the full state
+	trap_SendClientCommand("sync");
 }
 
 /*
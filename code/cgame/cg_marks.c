@@ -8,6 +8,11 @@ markPoly_t cg_activeMarkPolys; // double linked list
 markPoly_t *cg_freeMarkPolys;  // single linked list
 markPoly_t cg_markPolys[MAX_MARK_POLYS];
 
+// mark vertexes are allocated in order from a ring, so the oldest mark
+// always owns the verts right after cg_markVertHead
+static polyVert_t cg_markVerts[MAX_MARK_VERTS];
+static int cg_markVertHead;
+
 /*
 ===================
 CG_InitMarkPolys
@@ -19,11 +24,12 @@ void CG_InitMarkPolys(void) {
 	int i;
 
 	memset(cg_markPolys, 0, sizeof(cg_markPolys));
+	cg_markVertHead = 0;
 
 	cg_activeMarkPolys.nextMark = &cg_activeMarkPolys;
 	cg_activeMarkPolys.prevMark = &cg_activeMarkPolys;
 	cg_freeMarkPolys = cg_markPolys;
-	for(i = 0; i < MAX_LOCAL_ENTITIES * 2 - 1; i++) {
+	for(i = 0; i < MAX_MARK_POLYS - 1; i++) {
 		cg_markPolys[i].nextMark = &cg_markPolys[i + 1];
 	}
 }
@@ -73,6 +79,38 @@ static markPoly_t *CG_AllocMark(void) {
 	return le;
 }
 
+/*
+===================
+CG_AllocMarkVerts
+
+Takes numVerts contiguous verts from the ring, freeing the oldest marks
+that are in the way
+===================
+*/
+static polyVert_t *CG_AllocMarkVerts(int numVerts) {
+	markPoly_t *oldest;
+	polyVert_t *verts;
+	int first;
+
+	if(cg_markVertHead + numVerts > MAX_MARK_VERTS) {
+		// the marks left at the end of the ring are the oldest ones
+		while((oldest = cg_activeMarkPolys.prevMark) != &cg_activeMarkPolys && oldest->verts - cg_markVerts >= cg_markVertHead) {
+			CG_FreeMarkPoly(oldest);
+		}
+		cg_markVertHead = 0;
+	}
+
+	while((oldest = cg_activeMarkPolys.prevMark) != &cg_activeMarkPolys) {
+		first = oldest->verts - cg_markVerts;
+		if(first >= cg_markVertHead + numVerts || first + oldest->numVerts <= cg_markVertHead) break;
+		CG_FreeMarkPoly(oldest);
+	}
+
+	verts = &cg_markVerts[cg_markVertHead];
+	cg_markVertHead += numVerts;
+	return verts;
+}
+
 /*
 =================
 CG_ImpactMark
@@ -83,7 +121,7 @@ passed to the renderer.
 =================
 */
 #define MAX_MARK_FRAGMENTS MAX_VERTS_ON_POLY
-#define MAX_MARK_POINTS MAX_MARK_POLYS
+#define MAX_MARK_POINTS 1024 * 8
 markFragment_t ST_markFragments[MAX_MARK_FRAGMENTS], *mf;
 vec3_t ST_markPoints[MAX_MARK_POINTS];
 polyVert_t ST_verts[MAX_VERTS_ON_POLY];
@@ -130,6 +168,7 @@ void CG_ImpactMark(qhandle_t markShader, const vec3_t origin, const vec3_t dir,
 
 		// we have an upper limit on the complexity of polygons
 		// that we store persistantly
+		if(mf->numPoints < 3) continue;
 		if(mf->numPoints > MAX_VERTS_ON_POLY) mf->numPoints = MAX_VERTS_ON_POLY;
 		for(j = 0, v = ST_verts; j < mf->numPoints; j++, v++) {
 			vec3_t delta;
@@ -148,12 +187,15 @@ void CG_ImpactMark(qhandle_t markShader, const vec3_t origin, const vec3_t dir,
 			continue;
 		}
 
-		// otherwise save it persistantly
+		// otherwise save it persistantly, the verts go first so the
+		// new mark can't be evicted for its own verts
+		v = CG_AllocMarkVerts(mf->numPoints);
 		mark = CG_AllocMark();
 		mark->time = cg.time;
 		mark->alphaFade = alphaFade;
 		mark->markShader = markShader;
-		mark->poly.numVerts = mf->numPoints;
+		mark->numVerts = mf->numPoints;
+		mark->verts = v;
 		mark->color[0] = red;
 		mark->color[1] = green;
 		mark->color[2] = blue;
@@ -168,8 +210,11 @@ void CG_AddMarks(void) {
 	markPoly_t *mp, *next;
 	int t;
 	int fade;
+	int effectsTime;
+
+	if(!cvarTrackedInt(cg_addMarks)) return;
 
-	if(!cvarInt("cg_addMarks")) return;
+	effectsTime = cvarTrackedInt(cg_effectsTime) * 1000;
 
 	mp = cg_activeMarkPolys.nextMark;
 	for(; mp != &cg_activeMarkPolys; mp = next) {
@@ -178,7 +223,7 @@ void CG_AddMarks(void) {
 		next = mp->nextMark;
 
 		// see if it is time to completely remove it
-		if(cg.time > mp->time + cvarInt("cg_effectsTime") * 1000) {
+		if(cg.time > mp->time + effectsTime) {
 			CG_FreeMarkPoly(mp);
 			continue;
 		}
@@ -191,7 +236,7 @@ void CG_AddMarks(void) {
 					fade = 0;
 				}
 				if(mp->verts[0].modulate[0] != 0) {
-					for(j = 0; j < mp->poly.numVerts; j++) {
+					for(j = 0; j < mp->numVerts; j++) {
 						mp->verts[j].modulate[0] = mp->color[0] * fade;
 						mp->verts[j].modulate[1] = mp->color[1] * fade;
 						mp->verts[j].modulate[2] = mp->color[2] * fade;
@@ -201,15 +246,15 @@ void CG_AddMarks(void) {
 		}
 
 		// fade all marks out with time
-		t = mp->time + cvarInt("cg_effectsTime") * 1000 - cg.time;
+		t = mp->time + effectsTime - cg.time;
 		if(t < MARK_FADE_TIME) {
 			fade = 255 * t / MARK_FADE_TIME;
 			if(mp->alphaFade) {
-				for(j = 0; j < mp->poly.numVerts; j++) {
+				for(j = 0; j < mp->numVerts; j++) {
 					mp->verts[j].modulate[3] = fade;
 				}
 			} else {
-				for(j = 0; j < mp->poly.numVerts; j++) {
+				for(j = 0; j < mp->numVerts; j++) {
 					mp->verts[j].modulate[0] = mp->color[0] * fade;
 					mp->verts[j].modulate[1] = mp->color[1] * fade;
 					mp->verts[j].modulate[2] = mp->color[2] * fade;
@@ -217,6 +262,6 @@ void CG_AddMarks(void) {
 			}
 		}
 
-		trap_R_AddPolyToScene(mp->markShader, mp->poly.numVerts, mp->verts);
+		trap_R_AddPolyToScene(mp->markShader, mp->numVerts, mp->verts);
 	}
 }
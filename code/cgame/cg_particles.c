@@ -0,0 +1,103 @@
+// Copyright (C) 2023-2025 Noire.dev
+// OpenSandbox — GPLv2; see LICENSE for details.
+
+#include "../shared/javascript.h"
+
+/*
+====================
+Particles
+
+Sparks and bubbles are simple fading sprites on a fixed trajectory, so they
+are kept out of the local entity pool in a ring of their own. Each field is
+a separate array and a particle is just a ring slot, spawning fills a few
+fields instead of clearing a whole localEntity_t. When the ring is full the
+oldest particle is replaced, the local entities are never touched.
+====================
+*/
+
+#define MAX_PARTICLES 8192 // must be a power of two
+#define PARTICLE_MASK (MAX_PARTICLES - 1)
+
+static struct {
+	vec3_t base[MAX_PARTICLES];
+	vec3_t delta[MAX_PARTICLES];
+	int startTime[MAX_PARTICLES];
+	int endTime[MAX_PARTICLES];
+	float lifeRate[MAX_PARTICLES];
+	float radius[MAX_PARTICLES];
+	float gravity[MAX_PARTICLES]; // 0 or 1, scales BG_Gravity
+	byte color[MAX_PARTICLES][4];
+	qhandle_t shader[MAX_PARTICLES];
+
+	// spawn counters, the live particles are tail .. head - 1
+	int head, tail;
+} cg_particles;
+
+/*
+===================
+CG_InitParticles
+
+This is called at startup and for tournement restarts
+===================
+*/
+void CG_InitParticles(void) {
+	cg_particles.head = cg_particles.tail = 0;
+}
+
+void CG_SpawnParticle(const vec3_t origin, const vec3_t velocity, qboolean gravity, int lifetime, float radius, qhandle_t shader, const byte *color) {
+	int n;
+
+	if(lifetime < 1) lifetime = 1;
+
+	// replace the oldest particle when the ring is full
+	if(cg_particles.head - cg_particles.tail >= MAX_PARTICLES) cg_particles.tail++;
+
+	n = cg_particles.head++ & PARTICLE_MASK;
+	VectorCopy(origin, cg_particles.base[n]);
+	VectorCopy(velocity, cg_particles.delta[n]);
+	cg_particles.startTime[n] = cg.time;
+	cg_particles.endTime[n] = cg.time + lifetime;
+	cg_particles.lifeRate[n] = 1.0 / lifetime;
+	cg_particles.radius[n] = radius;
+	cg_particles.gravity[n] = gravity ? 1 : 0;
+	cg_particles.color[n][0] = color[0];
+	cg_particles.color[n][1] = color[1];
+	cg_particles.color[n][2] = color[2];
+	cg_particles.shader[n] = shader;
+}
+
+void CG_AddParticles(void) {
+	refEntity_t re;
+	float halfGravity, dt, c;
+	int i, n;
+
+	// expired particles at the tail are dropped, the ones in between
+	// are skipped until the tail reaches them
+	while(cg_particles.tail != cg_particles.head && cg.time >= cg_particles.endTime[cg_particles.tail & PARTICLE_MASK]) cg_particles.tail++;
+	if(cg_particles.tail == cg_particles.head) return;
+
+	memset(&re, 0, sizeof(re));
+	re.reType = RT_SPRITE;
+	halfGravity = 0.5 * BG_Gravity();
+
+	for(i = cg_particles.tail; i != cg_particles.head; i++) {
+		n = i & PARTICLE_MASK;
+		if(cg.time >= cg_particles.endTime[n]) continue;
+
+		dt = (cg.time - cg_particles.startTime[n]) * 0.001;
+		VectorMA(cg_particles.base[n], dt, cg_particles.delta[n], re.origin);
+		re.origin[2] -= cg_particles.gravity[n] * halfGravity * dt * dt;
+
+		c = (cg_particles.endTime[n] - cg.time) * cg_particles.lifeRate[n];
+		re.shaderRGBA[0] = cg_particles.color[n][0];
+		re.shaderRGBA[1] = cg_particles.color[n][1];
+		re.shaderRGBA[2] = cg_particles.color[n][2];
+		re.shaderRGBA[3] = 0xff * c;
+
+		re.radius = cg_particles.radius[n];
+		re.customShader = cg_particles.shader[n];
+		re.shaderTime = cg_particles.startTime[n] / 1000.0f;
+
+		trap_R_AddRefEntityToScene(&re);
+	}
+}
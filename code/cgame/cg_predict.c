@@ -4,6 +4,18 @@
 
 #include "../shared/javascript.h"
 
+#define SOLID_GRID_CELL 256       // world units per broadphase cell
+#define SOLID_GRID_HASH 4096      // cell buckets, power of two
+#define SOLID_GRID_MAXCELLS 8     // entities covering more cells go to the large list
+#define SOLID_GRID_QUERYCELLS 64  // traces covering more cells scan linearly
+#define SOLID_GRID_MARGIN 16      // slack for lerp and extrapolation between snapshots
+#define SOLID_GRID_LOOKAHEAD 0.2f // seconds of trajectory covered past the snapshot
+
+typedef struct {
+	int solid; // index into cg_solidEntities
+	int next;  // next link in bucket, -1 terminates
+} solidGridLink_t;
+
 static pmove_t cg_pmove;
 
 static int cg_numSolidEntities;
@@ -11,6 +23,101 @@ static centity_t *cg_solidEntities[MAX_ENTITIES_IN_SNAPSHOT];
 static int cg_numTriggerEntities;
 static centity_t *cg_triggerEntities[MAX_ENTITIES_IN_SNAPSHOT];
 
+// inline models have no client side bounds, they are always traced
+static int cg_numSolidBModels;
+static int cg_solidBModels[MAX_ENTITIES_IN_SNAPSHOT];
+static int cg_numSolidLarge;
+static int cg_solidLarge[MAX_ENTITIES_IN_SNAPSHOT];
+
+static int solidGridHead[SOLID_GRID_HASH];
+static solidGridLink_t solidGridLinks[MAX_ENTITIES_IN_SNAPSHOT * SOLID_GRID_MAXCELLS];
+static int solidGridNumLinks;
+static int solidGridStamp[MAX_ENTITIES_IN_SNAPSHOT];
+static int solidGridQuery;
+
+static int CG_GridCoord(float v) {
+	int c;
+
+	c = (int)(v / SOLID_GRID_CELL);
+	if(v < 0 && c * SOLID_GRID_CELL != v) c--;
+	return c;
+}
+
+static int CG_GridBucket(int cx, int cy) {
+	return ((cx * 73856093) ^ (cy * 19349663)) & (SOLID_GRID_HASH - 1);
+}
+
+/*
+==================
+CG_SolidRadius
+
+Encoded boxes are traced with the entity angles, so the
+broadphase uses the radius of the rotated box
+==================
+*/
+static float CG_SolidRadius(int solid) {
+	float x, zd, zu, z;
+
+	x = (solid & 255);
+	zd = ((solid >> 8) & 255);
+	zu = ((solid >> 16) & 255) - 32;
+	z = zd > zu ? zd : zu;
+
+	return sqrt(2 * x * x + z * z);
+}
+
+static void CG_AddSolidToGrid(int index) {
+	centity_t *cent;
+	vec3_t mins, maxs;
+	float radius, r;
+	int i, cx, cy, x0, y0, x1, y1;
+
+	cent = cg_solidEntities[index];
+
+	if(cent->currentState.solid == SOLID_BMODEL || cent->nextState.solid == SOLID_BMODEL) {
+		cg_solidBModels[cg_numSolidBModels++] = index;
+		return;
+	}
+
+	// cover everywhere the entity can be traced before the next list rebuild
+	radius = CG_SolidRadius(cent->currentState.solid);
+	r = CG_SolidRadius(cent->nextState.solid);
+	if(r > radius) radius = r;
+	radius += SOLID_GRID_MARGIN + VectorLength(cent->currentState.pos.trDelta) * SOLID_GRID_LOOKAHEAD;
+	if(cent->currentState.pos.trType == TR_GRAVITY) radius += 0.5f * BG_Gravity() * SOLID_GRID_LOOKAHEAD * SOLID_GRID_LOOKAHEAD;
+	if(cent->currentState.pos.trType == TR_GRAVITY_WATER) radius += 0.5f * (BG_Gravity() * 0.5f) * SOLID_GRID_LOOKAHEAD * SOLID_GRID_LOOKAHEAD;
+
+	for(i = 0; i < 3; i++) {
+		mins[i] = cent->lerpOrigin[i];
+		maxs[i] = cent->lerpOrigin[i];
+		if(cent->currentState.pos.trBase[i] < mins[i]) mins[i] = cent->currentState.pos.trBase[i];
+		if(cent->currentState.pos.trBase[i] > maxs[i]) maxs[i] = cent->currentState.pos.trBase[i];
+		if(cent->nextState.pos.trBase[i] < mins[i]) mins[i] = cent->nextState.pos.trBase[i];
+		if(cent->nextState.pos.trBase[i] > maxs[i]) maxs[i] = cent->nextState.pos.trBase[i];
+		mins[i] -= radius;
+		maxs[i] += radius;
+	}
+
+	x0 = CG_GridCoord(mins[0]);
+	y0 = CG_GridCoord(mins[1]);
+	x1 = CG_GridCoord(maxs[0]);
+	y1 = CG_GridCoord(maxs[1]);
+
+	if((x1 - x0 + 1) * (y1 - y0 + 1) > SOLID_GRID_MAXCELLS) {
+		cg_solidLarge[cg_numSolidLarge++] = index;
+		return;
+	}
+
+	for(cx = x0; cx <= x1; cx++) {
+		for(cy = y0; cy <= y1; cy++) {
+			i = CG_GridBucket(cx, cy);
+			solidGridLinks[solidGridNumLinks].solid = index;
+			solidGridLinks[solidGridNumLinks].next = solidGridHead[i];
+			solidGridHead[i] = solidGridNumLinks++;
+		}
+	}
+}
+
 /*
 ====================
 CG_BuildSolidList
@@ -28,6 +135,10 @@ void CG_BuildSolidList(void) {
 
 	cg_numSolidEntities = 0;
 	cg_numTriggerEntities = 0;
+	cg_numSolidBModels = 0;
+	cg_numSolidLarge = 0;
+	solidGridNumLinks = 0;
+	for(i = 0; i < SOLID_GRID_HASH; i++) solidGridHead[i] = -1;
 
 	if(cg.nextSnap && !cg.nextFrameTeleport && !cg.thisFrameTeleport) {
 		snap = cg.nextSnap;
@@ -47,61 +158,119 @@ void CG_BuildSolidList(void) {
 
 		if(cent->nextState.solid) {
 			cg_solidEntities[cg_numSolidEntities] = cent;
+			solidGridStamp[cg_numSolidEntities] = 0;
+			CG_AddSolidToGrid(cg_numSolidEntities);
 			cg_numSolidEntities++;
 			continue;
 		}
 	}
+
+	solidGridQuery = 0;
 }
 
-static void CG_ClipMoveToEntities(const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, int skipNumber, int mask, trace_t *tr, qboolean skip) {
+static void CG_ClipMoveToEntity(centity_t *cent, const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, const vec3_t sweepMins, const vec3_t sweepMaxs, int skipNumber, int mask, trace_t *tr) {
 	int i, x, zd, zu;
+	float radius;
 	trace_t trace;
 	entityState_t *ent;
 	clipHandle_t cmodel;
 	vec3_t bmins, bmaxs;
 	vec3_t origin, angles;
-	centity_t *cent;
 
-	for(i = 0; i < cg_numSolidEntities; i++) {
-		cent = cg_solidEntities[i];
-		ent = &cent->currentState;
+	ent = &cent->currentState;
 
-		if(ent->number == skipNumber) {
-			continue;
-		}
+	if(ent->number == skipNumber) {
+		return;
+	}
 
-		// FIXME: AABB colisions is coded to ONE INT, instead two vec3
-		if(ent->solid == SOLID_BMODEL) {
-			// special value for bmodel
-			cmodel = trap_CM_InlineModel(ent->modelindex);
-			VectorCopy(cent->lerpAngles, angles);
-			BG_EvaluateTrajectory(&cent->currentState.pos, cg.physicsTime, origin);
-		} else {
-			// encoded bbox
-			x = (ent->solid & 255);
-			zd = ((ent->solid >> 8) & 255);
-			zu = ((ent->solid >> 16) & 255) - 32;
-
-			bmins[0] = bmins[1] = -x;
-			bmaxs[0] = bmaxs[1] = x;
-			bmins[2] = -zd;
-			bmaxs[2] = zu;
-
-			cmodel = trap_CM_TempBoxModel(bmins, bmaxs);
-			VectorCopy(cent->lerpAngles, angles);
-			VectorCopy(cent->lerpOrigin, origin);
+	// FIXME: AABB colisions is coded to ONE INT, instead two vec3
+	if(ent->solid == SOLID_BMODEL) {
+		// special value for bmodel
+		cmodel = trap_CM_InlineModel(ent->modelindex);
+		VectorCopy(cent->lerpAngles, angles);
+		BG_EvaluateTrajectory(&cent->currentState.pos, cg.physicsTime, origin);
+	} else {
+		// reject before building a temp box if the sweep can't reach it
+		radius = CG_SolidRadius(ent->solid);
+		for(i = 0; i < 3; i++) {
+			if(cent->lerpOrigin[i] - radius > sweepMaxs[i] || cent->lerpOrigin[i] + radius < sweepMins[i]) {
+				return;
+			}
 		}
 
-		trap_CM_TransformedBoxTrace(&trace, start, end, mins, maxs, cmodel, mask, origin, angles);
+		// encoded bbox
+		x = (ent->solid & 255);
+		zd = ((ent->solid >> 8) & 255);
+		zu = ((ent->solid >> 16) & 255) - 32;
+
+		bmins[0] = bmins[1] = -x;
+		bmaxs[0] = bmaxs[1] = x;
+		bmins[2] = -zd;
+		bmaxs[2] = zu;
 
-		if(trace.allsolid || trace.fraction < tr->fraction) {
-			trace.entityNum = ent->number;
-			*tr = trace;
-		} else if(trace.startsolid) {
-			tr->startsolid = qtrue;
+		cmodel = trap_CM_TempBoxModel(bmins, bmaxs);
+		VectorCopy(cent->lerpAngles, angles);
+		VectorCopy(cent->lerpOrigin, origin);
+	}
+
+	trap_CM_TransformedBoxTrace(&trace, start, end, mins, maxs, cmodel, mask, origin, angles);
+
+	if(trace.allsolid || trace.fraction < tr->fraction) {
+		trace.entityNum = ent->number;
+		*tr = trace;
+	} else if(trace.startsolid) {
+		tr->startsolid = qtrue;
+	}
+}
+
+static void CG_ClipMoveToEntities(const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, int skipNumber, int mask, trace_t *tr, qboolean skip) {
+	int i, link, cx, cy, x0, y0, x1, y1;
+	vec3_t sweepMins, sweepMaxs;
+
+	for(i = 0; i < 3; i++) {
+		sweepMins[i] = (start[i] < end[i] ? start[i] : end[i]) + mins[i];
+		sweepMaxs[i] = (start[i] > end[i] ? start[i] : end[i]) + maxs[i];
+	}
+
+	// several cells can share a bucket and an entity can span cells
+	solidGridQuery++;
+
+	for(i = 0; i < cg_numSolidBModels; i++) {
+		solidGridStamp[cg_solidBModels[i]] = solidGridQuery;
+		CG_ClipMoveToEntity(cg_solidEntities[cg_solidBModels[i]], start, mins, maxs, end, sweepMins, sweepMaxs, skipNumber, mask, tr);
+		if(tr->allsolid) return;
+	}
+
+	for(i = 0; i < cg_numSolidLarge; i++) {
+		solidGridStamp[cg_solidLarge[i]] = solidGridQuery;
+		CG_ClipMoveToEntity(cg_solidEntities[cg_solidLarge[i]], start, mins, maxs, end, sweepMins, sweepMaxs, skipNumber, mask, tr);
+		if(tr->allsolid) return;
+	}
+
+	x0 = CG_GridCoord(sweepMins[0]);
+	y0 = CG_GridCoord(sweepMins[1]);
+	x1 = CG_GridCoord(sweepMaxs[0]);
+	y1 = CG_GridCoord(sweepMaxs[1]);
+
+	// long sweeps touch most buckets anyway, walk the list once
+	if((x1 - x0 + 1) * (y1 - y0 + 1) > SOLID_GRID_QUERYCELLS) {
+		for(i = 0; i < cg_numSolidEntities; i++) {
+			if(solidGridStamp[i] == solidGridQuery) continue;
+			CG_ClipMoveToEntity(cg_solidEntities[i], start, mins, maxs, end, sweepMins, sweepMaxs, skipNumber, mask, tr);
+			if(tr->allsolid) return;
 		}
-		if(tr->allsolid) {
-			return;
+		return;
+	}
+
+	for(cx = x0; cx <= x1; cx++) {
+		for(cy = y0; cy <= y1; cy++) {
+			for(link = solidGridHead[CG_GridBucket(cx, cy)]; link != -1; link = solidGridLinks[link].next) {
+				i = solidGridLinks[link].solid;
+				if(solidGridStamp[i] == solidGridQuery) continue;
+				solidGridStamp[i] = solidGridQuery;
+				CG_ClipMoveToEntity(cg_solidEntities[i], start, mins, maxs, end, sweepMins, sweepMaxs, skipNumber, mask, tr);
+				if(tr->allsolid) return;
+			}
 		}
 	}
 }
@@ -126,8 +295,8 @@ int CG_PointContents(const vec3_t point, int passEntityNum) {
 
 	contents = trap_CM_PointContents(point, 0);
 
-	for(i = 0; i < cg_numSolidEntities; i++) {
-		cent = cg_solidEntities[i];
+	for(i = 0; i < cg_numSolidBModels; i++) {
+		cent = cg_solidEntities[cg_solidBModels[i]];
 
 		ent = &cent->currentState;
 
@@ -28,27 +28,33 @@ static void CG_ParseScores(void) {
 
 static void CG_ParseRespawnTime(void) { cg.respawnTime = atoi(CG_Argv(1)); }
 
+// "gCvars <index> <value> ...", only the changed cvars
 static void CG_ParseGameCvars(void) {
-	mod_jumpheight = atoi(CG_Argv(1));
-	mod_gravity = atoi(CG_Argv(2));
+	int i, value;
+	int numArgs = trap_Argc();
+
+	for(i = 1; i + 1 < numArgs; i += 2) {
+		value = atoi(CG_Argv(i + 1));
+
+		switch(atoi(CG_Argv(i))) {
+		case GCVAR_JUMPHEIGHT: mod_jumpheight = value; break;
+		case GCVAR_GRAVITY: mod_gravity = value; break;
+		}
+	}
 }
 
+// "sweps <weapon> <status> ...", only the changed weapons
 static void CG_ParseSweps(void) {
 	int i;
-	int weaponIndex;
+	int weaponIndex, status;
 	int numArgs = trap_Argc();
 
-	for(i = 0; i < WEAPONS_NUM; i++) cg.swep_listcl[i] = WS_NONE;
-
-	for(i = 1; i < numArgs; i++) {
+	for(i = 1; i + 1 < numArgs; i += 2) {
 		weaponIndex = atoi(CG_Argv(i));
+		status = atoi(CG_Argv(i + 1));
 
-		if(weaponIndex >= -WEAPONS_NUM && weaponIndex < WEAPONS_NUM) {
-			if(weaponIndex > 0) {
-				cg.swep_listcl[weaponIndex] = WS_HAVE;
-			} else if(weaponIndex < 0) {
-				cg.swep_listcl[-weaponIndex] = WS_NOAMMO;
-			}
+		if(weaponIndex > 0 && weaponIndex < WEAPONS_NUM && status >= WS_NONE && status <= WS_NOAMMO) {
+			cg.swep_listcl[weaponIndex] = status;
 		}
 	}
 }
@@ -73,6 +79,40 @@ static void CG_ParseSpawnSweps(void) {
 	}
 }
 
+/*
+================
+CG_ParseToolgunInfo
+
+Expands "t_info <class> <model> <material> <count>" back into the
+text cg_draw.c shows, "-" fields become <NULL> and "@n" is a model index
+================
+*/
+static void CG_ParseToolgunInfo(void) {
+	const char *arg;
+	char field[MAX_QPATH];
+	int i, len;
+
+	cg.entityInfo[0] = '\0';
+	if(trap_Argc() < 1 + MAX_ENTITYINFO) return;
+
+	for(i = 1; i <= MAX_ENTITYINFO; i++) {
+		arg = CG_Argv(i);
+
+		if(!strcmp(arg, "-")) {
+			StringCopy(field, "<NULL>", sizeof(field));
+		} else if(i == 2 && arg[0] == '@' && atoi(arg + 1) > 0 && atoi(arg + 1) < MAX_MODELS) {
+			StringCopy(field, CG_ConfigString(CS_MODELS + atoi(arg + 1)), sizeof(field));
+			len = strlen(field);
+			if(len >= 4 && !Q_stricmp(field + len - 4, ".md3")) field[len - 4] = '\0';
+		} else {
+			StringCopy(field, arg, sizeof(field));
+		}
+
+		if(i > 1) Q_strcat(cg.entityInfo, sizeof(cg.entityInfo), " ");
+		Q_strcat(cg.entityInfo, sizeof(cg.entityInfo), field);
+	}
+}
+
 void CG_ParseServerinfo(void) {
 	const char *info;
 	char *mapname;
@@ -121,6 +161,7 @@ static void CG_ConfigStringModified(void) {
 		cg.intermissionStarted = atoi(str);
 	} else if(num >= CS_MODELS && num < CS_MODELS + MAX_MODELS) {
 		cgs.gameModels[num - CS_MODELS] = trap_R_RegisterModel(str);
+		CG_ClearMaterialCache();
 	} else if(num >= CS_SOUNDS && num < CS_SOUNDS + MAX_SOUNDS) {
 		if(str[0] != '*') cgs.gameSounds[num - CS_SOUNDS] = trap_S_RegisterSound(str, qfalse); // player specific sounds don't register here
 	} else if(num >= CS_PLAYERS && num < CS_PLAYERS + MAX_CLIENTS) {
@@ -131,6 +172,7 @@ static void CG_ConfigStringModified(void) {
 static void CG_MapRestart(void) {
 	CG_InitLocalEntities();
 	CG_InitMarkPolys();
+	CG_InitParticles();
 	cg.intermissionStarted = qfalse;
 	cg.mapRestart = qtrue;
 	trap_S_ClearLoopingSounds(qtrue);
@@ -229,7 +271,7 @@ static void CG_ServerCommand(void) {
 	}
 
 	if(!strcmp(cmd, "t_info")) {
-		StringCopy(cg.entityInfo, CG_Argv(1), sizeof(cg.entityInfo));
+		CG_ParseToolgunInfo();
 		return;
 	}
 
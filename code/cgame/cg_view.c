@@ -343,6 +343,7 @@ void CG_DrawActiveFrame(int serverTime, qboolean demoPlayback) {
 	cg.time = serverTime;
 	cg.demoPlayback = demoPlayback;
 
+	ST_UpdateCvars();
 	ST_UpdateCGUI();
 
 	if(cg.infoScreenText[0] != 0) {
@@ -363,8 +364,8 @@ void CG_DrawActiveFrame(int serverTime, qboolean demoPlayback) {
 	cg.clientFrame++;
 	CG_PredictPlayerState();
 
-	cg.renderingThirdPerson = cvarFloat("cg_thirdPerson") && cg.snap->ps.pm_type != PM_SPECTATOR || (cg.snap->ps.stats[STAT_HEALTH] <= 0) || cg.snap->ps.stats[STAT_VEHICLE];
-	cg.renderingEyesPerson = !cvarFloat("cg_thirdPerson") && cvarInt("cg_cameraEyes") && cg.snap->ps.pm_type != PM_SPECTATOR || cg.snap->ps.stats[STAT_VEHICLE];
+	cg.renderingThirdPerson = cvarTrackedFloat(cg_thirdPerson) && cg.snap->ps.pm_type != PM_SPECTATOR || (cg.snap->ps.stats[STAT_HEALTH] <= 0) || cg.snap->ps.stats[STAT_VEHICLE];
+	cg.renderingEyesPerson = !cvarTrackedFloat(cg_thirdPerson) && cvarTrackedInt(cg_cameraEyes) && cg.snap->ps.pm_type != PM_SPECTATOR || cg.snap->ps.stats[STAT_VEHICLE];
 
 	CG_CalcViewValues();
 
@@ -374,6 +375,7 @@ void CG_DrawActiveFrame(int serverTime, qboolean demoPlayback) {
 	CG_AddPacketEntities();
 	CG_AddMarks();
 	CG_AddLocalEntities();
+	CG_AddParticles();
 
 	CG_AddViewWeapon(&cg.predictedPlayerState);
 	CG_PlayBufferedSounds();
@@ -10,6 +10,45 @@ bot_state_t *botstates[MAX_CLIENTS];
 int numbots;
 float floattime;
 
+// team and faction of every client, refreshed each AI frame from the
+// same state ClientUserinfoChanged puts into the CS_PLAYERS strings
+typedef struct {
+	int team;
+	int npcType;
+	int faction;
+} botClientInfo_t;
+
+static botClientInfo_t botClients[MAX_CLIENTS];
+
+// what botlib last got for each entity slot. botlib drops entities that
+// are not updated every frame, so only clears can be skipped
+#define BOTENT_UNKNOWN 0
+#define BOTENT_CLEAR 1
+#define BOTENT_LINKED 2
+
+static byte botEntitySent[MAX_GENTITIES];
+static int botEntityUpdates, botEntityClears, botEntitySkipped;
+
+static void BotUpdateClientInfo(void) {
+	botClientInfo_t *info;
+	gentity_t *ent;
+	int i;
+
+	for(i = 0; i < MAX_CLIENTS; i++) {
+		ent = &g_entities[i];
+		info = &botClients[i];
+		if(!ent->client || ent->client->pers.connected == CON_DISCONNECTED) {
+			info->team = TEAM_FREE;
+			info->npcType = NT_NONE;
+		} else {
+			info->team = ent->client->sess.sessionTeam;
+			info->npcType = ent->npcType;
+		}
+		if(info->npcType < 0 || info->npcType >= gameInfoNPCTypesNum) info->npcType = NT_NONE;
+		info->faction = gameInfoNPCTypes[info->npcType].faction;
+	}
+}
+
 static int BotPointAreaNum(vec3_t origin) {
 	int areanum, numareas, areas[10];
 	vec3_t end;
@@ -99,10 +138,8 @@ static void BotSetupForMovement(bot_state_t *bs) {
 static qboolean BotIsDead(bot_state_t *bs) { return (bs->ent->client->ps.pm_type == PM_DEAD); }
 
 static qboolean BotIsObserver(bot_state_t *bs) {
-	char buf[MAX_INFO_STRING];
 	if(bs->ent->client->ps.pm_type == PM_SPECTATOR) return qtrue;
-	trap_GetConfigstring(CS_PLAYERS + bs->ent->client->ps.clientNum, buf, sizeof(buf));
-	if(atoi(Info_ValueForKey(buf, "t")) == TEAM_SPECTATOR) return qtrue;
+	if(botClients[bs->ent->client->ps.clientNum].team == TEAM_SPECTATOR) return qtrue;
 	return qfalse;
 }
 
@@ -112,19 +149,19 @@ static qboolean BotIntermission(bot_state_t *bs) {
 }
 
 static int BotSameTeam(bot_state_t *bs, int entnum) {
-	char info1[1024], info2[1024];
+	botClientInfo_t *self, *other;
 
 	if(bs->ent->client->ps.clientNum < 0 || bs->ent->client->ps.clientNum >= MAX_CLIENTS) return qfalse;
 
 	if(entnum < 0 || entnum >= MAX_CLIENTS) return qfalse;
 
-	trap_GetConfigstring(CS_PLAYERS + bs->ent->client->ps.clientNum, info1, sizeof(info1));
-	trap_GetConfigstring(CS_PLAYERS + entnum, info2, sizeof(info2));
+	self = &botClients[bs->ent->client->ps.clientNum];
+	other = &botClients[entnum];
 
-	if(cvarInt("g_gametype") >= GT_TEAM && atoi(Info_ValueForKey(info1, "nt")) <= NT_PLAYER) {
-		if(atoi(Info_ValueForKey(info1, "t")) == atoi(Info_ValueForKey(info2, "t"))) return qtrue;
+	if(cvarTrackedInt(g_gametype) >= GT_TEAM && self->npcType <= NT_PLAYER) {
+		if(self->team == other->team) return qtrue;
 	} else {
-		if(!BG_FactionShouldAttack(gameInfoNPCTypes[atoi(Info_ValueForKey(info1, "nt"))].faction, gameInfoNPCTypes[atoi(Info_ValueForKey(info2, "nt"))].faction)) return qtrue;
+		if(!BG_FactionShouldAttack(self->faction, other->faction)) return qtrue;
 	}
 	return qfalse;
 }
@@ -154,7 +191,7 @@ static qboolean BotFindEnemy(bot_state_t *bs) {
 
 	for(i = 0; i < MAX_CLIENTS; i++) {
 		ent = &g_entities[i];
-		if(!ent->client) continue;
+		if(!ent->inuse || !ent->client) continue;
 		if(!ent->health) continue;
 		if(ent->client->sess.sessionTeam == TEAM_SPECTATOR) continue;
 		if(ent->client->ps.clientNum == bs->ent->client->ps.clientNum) continue;
@@ -163,16 +200,16 @@ static qboolean BotFindEnemy(bot_state_t *bs) {
 		VectorSubtract(ent->r.currentOrigin, bs->ent->r.currentOrigin, dir);
 		squaredist = VectorLengthSquared(dir);
 		if(squaredist > Square(16384.00f)) continue;
+		if(bs->enemy >= 0 && squaredist > cursquaredist) continue; // the closest enemy wins, skip the trace
 		if(BotSameTeam(bs, i)) continue;
 
 		if(bs->ent->npcType != NT_NEXTBOT)
-			vis = BotEntityVisible(bs->ent->s.number, bs->eye, i);
+			vis = trap_InPVS(bs->eye, ent->r.currentOrigin) && BotEntityVisible(bs->ent->s.number, bs->eye, i);
 		else
 			vis = qtrue;
 
 		if(!vis) continue;
 
-		if(bs->enemy >= 0 && squaredist > cursquaredist) continue;
 		bs->enemy = i;
 		cursquaredist = squaredist;
 		enemyFound = qtrue;
@@ -502,6 +539,10 @@ int BotAILoadMap(int restart) {
 
 	if(!restart) trap_BotLibLoadMap(cvarString("sv_mapname"));
 
+	// a new map starts botlib without entities, send every slot once
+	memset(botEntitySent, BOTENT_UNKNOWN, sizeof(botEntitySent));
+	botEntityUpdates = botEntityClears = botEntitySkipped = 0;
+
 	for(i = 0; i < MAX_CLIENTS; i++) {
 		if(botstates[i] && botstates[i]->inuse) {
 			BotResetState(botstates[i]);
@@ -535,7 +576,13 @@ int AI_Frame(int time) {
 			ent = &g_entities[i];
 
 			if(!ent->inuse || !ent->r.linked || ent->client || ent->r.svFlags & SVF_NOCLIENT || ent->s.eType != ET_MOVER || ent->r.contents == CONTENTS_TRIGGER) {
+				if(botEntitySent[i] == BOTENT_CLEAR) {
+					botEntitySkipped++;
+					continue;
+				}
 				trap_BotUpdateEntity(i, NULL);
+				botEntitySent[i] = BOTENT_CLEAR;
+				botEntityClears++;
 				continue;
 			}
 
@@ -562,11 +609,15 @@ int AI_Frame(int time) {
 			state.weapon = ent->s.weapon;
 
 			trap_BotUpdateEntity(i, &state);
+			botEntitySent[i] = BOTENT_LINKED;
+			botEntityUpdates++;
 		}
 	}
 
 	floattime = trap_AAS_Time();
 
+	BotUpdateClientInfo();
+
 	for(i = 0; i < MAX_CLIENTS; i++) {
 		if(!botstates[i] || !botstates[i]->inuse) continue;
 		botstates[i]->botthink_residual += elapsed_time;
@@ -588,6 +639,13 @@ int AI_Frame(int time) {
 	return qtrue;
 }
 
+void BotAIStats_f(void) {
+	int total;
+
+	total = botEntityUpdates + botEntityClears + botEntitySkipped;
+	print("botlib entity slots: %i updated, %i cleared, %i skipped (%.1f%% of syscalls saved)\n", botEntityUpdates, botEntityClears, botEntitySkipped, total ? botEntitySkipped * 100.0f / total : 0.0f);
+}
+
 int BotAISetup(int restart) {
 	int errnum;
 
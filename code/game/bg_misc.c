@@ -30,10 +30,11 @@ item_t gameInfoItems[] = {
 	{ "weapon_gravitygun", 			"models/weapons/physgun/physgun.md3",			"icons/iconw_gravitygun",	"Gravitygun",			0,		IT_WEAPON,		WP_GRAVITYGUN },
 	{ "weapon_toolgun", 			"models/weapons/toolgun/toolgun.md3",			"icons/iconw_toolgun",		"Toolgun",				0,		IT_WEAPON,		WP_TOOLGUN },
 	{ "ammo_bullets",				"models/powerups/ammo/machinegunam.md3",		"icons/icona_machinegun",	"Bullets",				50,		IT_AMMO,		WP_MACHINEGUN },
+	{ NULL }
 };
 // clang-format on
 
-int gameInfoItemsNum = ARRAY_SIZE(gameInfoItems);
+int gameInfoItemsNum = ARRAY_SIZE(gameInfoItems) - 1; // terminator is not an item
 
 // clang-format off
 weaponProperties_t gameInfoWeapons[] = {
@@ -285,6 +286,13 @@ qboolean BG_CanItemBeGrabbed(int gametype, const entityState_t *ent, const playe
 	return qfalse;
 }
 
+static cvarHandle_t bg_gravity = CVAR_NOHANDLE;
+
+float BG_Gravity(void) {
+	if(bg_gravity == CVAR_NOHANDLE) bg_gravity = cvarTrack("g_gravity");
+	return cvarTrackedFloat(bg_gravity);
+}
+
 void BG_EvaluateTrajectory(const trajectory_t *tr, int atTime, vec3_t result) {
 	float deltaTime;
 	float phase;
@@ -314,7 +322,7 @@ void BG_EvaluateTrajectory(const trajectory_t *tr, int atTime, vec3_t result) {
 	case TR_GRAVITY:
 		deltaTime = (atTime - tr->trTime) * 0.001; // milliseconds to seconds
 		VectorMA(tr->trBase, deltaTime, tr->trDelta, result);
-		result[2] -= 0.5 * cvarFloat("g_gravity") * deltaTime * deltaTime;
+		result[2] -= 0.5 * BG_Gravity() * deltaTime * deltaTime;
 		break;
 	case TR_ROTATING:
 		if(tr->trTime > 0)
@@ -328,7 +336,7 @@ void BG_EvaluateTrajectory(const trajectory_t *tr, int atTime, vec3_t result) {
 	case TR_GRAVITY_WATER:
 		deltaTime = (atTime - tr->trTime) * 0.001; // milliseconds to seconds
 		VectorMA(tr->trBase, deltaTime, tr->trDelta, result);
-		result[2] -= 0.5 * (cvarFloat("g_gravity") * 0.50) * deltaTime * deltaTime;
+		result[2] -= 0.5 * (BG_Gravity() * 0.50) * deltaTime * deltaTime;
 		break;
 	default: break;
 	}
@@ -366,12 +374,12 @@ void BG_EvaluateTrajectoryDelta(const trajectory_t *tr, int atTime, vec3_t resul
 	case TR_GRAVITY:
 		deltaTime = (atTime - tr->trTime) * 0.001; // milliseconds to seconds
 		VectorCopy(tr->trDelta, result);
-		result[2] -= cvarFloat("g_gravity") * deltaTime;
+		result[2] -= BG_Gravity() * deltaTime;
 		break;
 	case TR_GRAVITY_WATER:
 		deltaTime = (atTime - tr->trTime) * 0.001; // milliseconds to seconds
 		VectorCopy(tr->trDelta, result);
-		result[2] -= (cvarFloat("g_gravity") * 0.50) * deltaTime;
+		result[2] -= (BG_Gravity() * 0.50) * deltaTime;
 		break;
 	default: break;
 	}
@@ -406,12 +414,12 @@ void ST_EvaluateTrajectory(const trajectory_t *tr, int atTime, vec3_t result, fl
 	case TR_GRAVITY:
 		deltaTime = (atTime - tr->trTime) * 0.001; // milliseconds to seconds
 		VectorMA(tr->trBase, deltaTime, tr->trDelta, result);
-		result[2] -= 0.5 * (cvarFloat("g_gravity") * mass) * deltaTime * deltaTime;
+		result[2] -= 0.5 * (BG_Gravity() * mass) * deltaTime * deltaTime;
 		break;
 	case TR_GRAVITY_WATER:
 		deltaTime = (atTime - tr->trTime) * 0.001; // milliseconds to seconds
 		VectorMA(tr->trBase, deltaTime, tr->trDelta, result);
-		result[2] -= 0.5 * (cvarFloat("g_gravity") * (mass * 0.50)) * deltaTime * deltaTime;
+		result[2] -= 0.5 * (BG_Gravity() * (mass * 0.50)) * deltaTime * deltaTime;
 		break;
 	case TR_ROTATING:
 		if(tr->trTime > 0)
@@ -460,12 +468,12 @@ void ST_EvaluateTrajectoryDelta(const trajectory_t *tr, int atTime, vec3_t resul
 	case TR_GRAVITY:
 		deltaTime = (atTime - tr->trTime) * 0.001; // milliseconds to seconds
 		VectorCopy(tr->trDelta, result);
-		result[2] -= (cvarFloat("g_gravity") * mass) * deltaTime;
+		result[2] -= (BG_Gravity() * mass) * deltaTime;
 		break;
 	case TR_GRAVITY_WATER:
 		deltaTime = (atTime - tr->trTime) * 0.001; // milliseconds to seconds
 		VectorCopy(tr->trDelta, result);
-		result[2] -= (cvarFloat("g_gravity") * (mass * 0.50)) * deltaTime;
+		result[2] -= (BG_Gravity() * (mass * 0.50)) * deltaTime;
 		break;
 	default:
 		err("unknown trType");
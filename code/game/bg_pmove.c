@@ -1037,6 +1037,7 @@ are being updated isntead of a full move
 */
 void PM_UpdateViewAngles(playerState_t *ps, const usercmd_t *cmd) {
 	short temp;
+	int cmdAngle;
 	int i;
 
 	if(pm->cmd.buttons & BUTTON_USE && pm->cmd.buttons & BUTTON_ATTACK && pm->ps->weapon == WP_PHYSGUN) {
@@ -1053,14 +1054,15 @@ void PM_UpdateViewAngles(playerState_t *ps, const usercmd_t *cmd) {
 
 	// circularly clamp the angles with deltas
 	for(i = 0; i < 3; i++) {
-		temp = cmd->angles[i] + ps->delta_angles[i];
+		cmdAngle = i < 2 ? cmd->angles[i] : 0; // usercmd_t carries no roll
+		temp = cmdAngle + ps->delta_angles[i];
 		if(i == PITCH) {
 			// don't let the player look up or down more than 90 degrees
 			if(temp > 16000) {
-				ps->delta_angles[i] = 16000 - cmd->angles[i];
+				ps->delta_angles[i] = 16000 - cmdAngle;
 				temp = 16000;
 			} else if(temp < -16000) {
-				ps->delta_angles[i] = -16000 - cmd->angles[i];
+				ps->delta_angles[i] = -16000 - cmdAngle;
 				temp = -16000;
 			}
 		}
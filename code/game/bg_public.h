@@ -30,6 +30,8 @@
 #define PHYS_PROP_IMPACT 0.80
 #define PHYS_SENS 450
 #define PHYS_DAMAGE 0.60
+#define PHYS_SLEEPTIME 1000 // msec at rest before a prop stops simulating
+#define PHYS_WAKERANGE 2    // contact margin for waking touching props
 #endif
 
 // entity info
@@ -40,6 +42,9 @@
 #define WS_HAVE 1
 #define WS_NOAMMO 2
 
+// game cvars replicated to clients by index
+typedef enum { GCVAR_JUMPHEIGHT, GCVAR_GRAVITY, GAMECVARS_NUM } gameCvar_t;
+
 typedef enum {
 	OT_VANILLAQ3,
 	OT_BASIC,
@@ -526,6 +531,7 @@ item_t *BG_FindWeapon(int id);
 item_t *BG_FindAmmo(int id);
 qboolean BG_PlayerTouchesItem(playerState_t *ps, entityState_t *item, int atTime);
 qboolean BG_CanItemBeGrabbed(int gametype, const entityState_t *ent, const playerState_t *ps);
+float BG_Gravity(void);
 void BG_EvaluateTrajectory(const trajectory_t *tr, int atTime, vec3_t result);
 void BG_EvaluateTrajectoryDelta(const trajectory_t *tr, int atTime, vec3_t result);
 void ST_EvaluateTrajectory(const trajectory_t *tr, int atTime, vec3_t result, float mass);
@@ -291,8 +291,8 @@ static void ClientTimerActions(gentity_t *ent, int msec) {
 		
 		if(ent->health+1 <= MAX_PLAYER_HEALTH) ent->health += 1;
 
-		G_SendGameCvars(ent);   // send game setting to client for sync
-		G_SendSwepWeapons(ent); // send sweps list to client for sync
+		G_SendGameCvars(ent);   // send changed game settings to client
+		G_SendSwepWeapons(ent); // send changed sweps to client
 	}
 }
 
@@ -18,4 +18,123 @@ void *G_Alloc(int size) {
 	return p;
 }
 
-void G_InitMemory(void) { allocPoint = 0; }
+/*
+====================
+Entity strings
+
+Strings owned by one entity come from size-classed chunks that are
+chained to the entity and go back to per-class free lists in G_FreeEntity
+====================
+*/
+
+#define STRINGPOOLSIZE (1024 * 1024)
+#define STRING_CLASSES 7 // 32 .. 2048 byte chunks, header included
+
+typedef struct {
+	int next;       // next chunk of the same entity, offset + 1
+	int chunkClass;
+} stringChunk_t;
+
+static char stringPool[STRINGPOOLSIZE];
+static int stringPoolPoint;
+static int stringFree[STRING_CLASSES]; // free lists, offset + 1
+static int stringUsed[STRING_CLASSES];
+static int stringCached[STRING_CLASSES];
+
+char *G_EntityString(gentity_t *ent, const char *string) {
+	stringChunk_t *chunk;
+	int len, chunkClass, ofs;
+
+	if(!string) return NULL;
+
+	// longer strings are clamped to the largest chunk
+	len = strlen(string) + 1 + sizeof(stringChunk_t);
+	if(len > (32 << (STRING_CLASSES - 1))) {
+		print("G_EntityString: string of %i chars truncated\n", (int)strlen(string));
+		len = 32 << (STRING_CLASSES - 1);
+	}
+	for(chunkClass = 0; (32 << chunkClass) < len; chunkClass++);
+
+	if(stringFree[chunkClass]) {
+		ofs = stringFree[chunkClass] - 1;
+		stringFree[chunkClass] = ((stringChunk_t *)&stringPool[ofs])->next;
+		stringCached[chunkClass]--;
+	} else {
+		iferr(stringPoolPoint + (32 << chunkClass) > STRINGPOOLSIZE);
+		ofs = stringPoolPoint;
+		stringPoolPoint += 32 << chunkClass;
+	}
+	stringUsed[chunkClass]++;
+
+	chunk = (stringChunk_t *)&stringPool[ofs];
+	chunk->chunkClass = chunkClass;
+	chunk->next = ent->stringChain;
+	ent->stringChain = ofs + 1;
+
+	StringCopy((char *)(chunk + 1), string, len - sizeof(stringChunk_t));
+	return (char *)(chunk + 1);
+}
+
+/*
+================
+G_SetEntityString
+
+Replaces a string field of the entity, the old value goes back to the
+free lists if the entity owns it
+================
+*/
+void G_SetEntityString(gentity_t *ent, char **field, const char *string) {
+	stringChunk_t *chunk;
+	char *old;
+	int *link, ofs;
+
+	old = *field;
+	*field = G_EntityString(ent, string);
+	if(!old) return;
+
+	for(link = &ent->stringChain; *link; link = &chunk->next) {
+		ofs = *link;
+		chunk = (stringChunk_t *)&stringPool[ofs - 1];
+		if((char *)(chunk + 1) != old) continue;
+
+		*link = chunk->next;
+		chunk->next = stringFree[chunk->chunkClass];
+		stringFree[chunk->chunkClass] = ofs;
+		stringUsed[chunk->chunkClass]--;
+		stringCached[chunk->chunkClass]++;
+		return;
+	}
+}
+
+void G_FreeEntityStrings(gentity_t *ent) {
+	stringChunk_t *chunk;
+	int ofs, next;
+
+	for(ofs = ent->stringChain; ofs; ofs = next) {
+		chunk = (stringChunk_t *)&stringPool[ofs - 1];
+		next = chunk->next;
+		chunk->next = stringFree[chunk->chunkClass];
+		stringFree[chunk->chunkClass] = ofs;
+		stringUsed[chunk->chunkClass]--;
+		stringCached[chunk->chunkClass]++;
+	}
+	ent->stringChain = 0;
+}
+
+void G_MemoryStats_f(void) {
+	int i;
+
+	print("G_Alloc pool: %i / %i bytes\n", allocPoint, POOLSIZE);
+	print("entity strings: %i / %i bytes\n", stringPoolPoint, STRINGPOOLSIZE);
+	for(i = 0; i < STRING_CLASSES; i++) {
+		print("%5i bytes: %6i used %6i free\n", 32 << i, stringUsed[i], stringCached[i]);
+	}
+}
+
+void G_InitMemory(void) {
+	allocPoint = 0;
+	stringPoolPoint = 0;
+	memset(stringFree, 0, sizeof(stringFree));
+	memset(stringUsed, 0, sizeof(stringUsed));
+	memset(stringCached, 0, sizeof(stringCached));
+}
@@ -0,0 +1,204 @@
+// Copyright (C) 2023-2025 Noire.dev
+// OpenSandbox — GPLv2; see LICENSE for details.
+
+#include "../shared/javascript.h"
+
+/*
+====================
+Autosave
+
+Sandbox objects are journaled to one of two files by passes that are
+spread over server frames, each frame spends at most g_autosaveBudget
+msec. A pass starts every g_autosave seconds and appends a record for
+every object that changed since it was last written and for every slot
+that was emptied. When the journal holds mostly stale records the pass
+compacts instead: it writes all objects to the other file and closes
+it with an end record, so a crash mid-pass always leaves one complete
+journal. loadautosave loads the newest complete one.
+====================
+*/
+
+#define AUTOSAVE_FILE "autosave/autosave%i.journal" // kept out of the maps/*.ent save list
+#define AUTOSAVE_CHUNK 0x10000
+#define AUTOSAVE_CHECK 32 // slots between budget checks
+#define AUTOSAVE_BUDGET 2 // msec when g_autosaveBudget is not positive
+
+typedef struct {
+	fileHandle_t f;   // journal that passes append to
+	fileHandle_t out; // journal the current pass writes
+	int file;         // index of f, or of the newest journal on disk
+	int target;       // index of out
+	int generation;
+
+	qboolean running;
+	qboolean compacting;
+	int cursor; // next slot of the pass
+	int nextTime;
+
+	int records; // records in the journal, stale ones included
+	int objects; // slots holding an object in the journal
+	byte saved[MAX_GENTITIES];
+
+	int len;
+	byte buf[AUTOSAVE_CHUNK];
+} autosave_t;
+
+static autosave_t autosave;
+
+static void G_AutosaveFlush(void) {
+	if(autosave.len) FS_Write(autosave.buf, autosave.len, autosave.out);
+	autosave.len = 0;
+}
+
+static void G_AutosaveRecord(int slot, gentity_t *ent) {
+	int len;
+
+	len = G_JournalRecord(autosave.buf + autosave.len, AUTOSAVE_CHUNK - autosave.len, slot, ent);
+	if(len < 0) {
+		G_AutosaveFlush();
+		len = G_JournalRecord(autosave.buf, AUTOSAVE_CHUNK, slot, ent);
+		iferr(len < 0);
+	}
+	autosave.len += len;
+	autosave.records++;
+}
+
+/*
+================
+G_AutosaveStart
+
+Compacts into the other journal on the first pass of a level and when
+less than half of the records are still current
+================
+*/
+static void G_AutosaveStart(void) {
+	int i, generation, len;
+
+	autosave.running = qtrue;
+	autosave.cursor = 0;
+	autosave.compacting = !autosave.f || autosave.records > autosave.objects * 2 + 64;
+
+	if(!autosave.compacting) {
+		autosave.out = autosave.f;
+		return;
+	}
+
+	if(!autosave.f) { // continue the numbering of the journals on disk
+		for(i = 0; i < 2; i++) {
+			generation = G_JournalGeneration(va(AUTOSAVE_FILE, i));
+			if(generation > autosave.generation) {
+				autosave.generation = generation;
+				autosave.file = i;
+			}
+		}
+	}
+
+	autosave.target = !autosave.file;
+	autosave.generation++;
+	FS_Open(va(AUTOSAVE_FILE, autosave.target), &autosave.out, FS_WRITE);
+
+	autosave.records = autosave.objects = 0;
+	memset(autosave.saved, 0, sizeof(autosave.saved));
+
+	len = G_JournalHeader(autosave.buf, AUTOSAVE_CHUNK, autosave.generation);
+	iferr(len < 0);
+	autosave.len = len;
+}
+
+static void G_AutosaveFinish(void) {
+	if(autosave.compacting) {
+		G_AutosaveRecord(-1, NULL);
+		G_AutosaveFlush();
+		if(autosave.f) FS_Close(autosave.f);
+		autosave.f = autosave.out;
+		autosave.file = autosave.target;
+	}
+	G_AutosaveFlush();
+
+	autosave.running = qfalse;
+	autosave.nextTime = level.time + cvarTrackedInt(g_autosave) * 1000;
+}
+
+static void G_AutosaveSlot(int slot) {
+	gentity_t *ent = &g_entities[slot];
+
+	if(G_MapfileSaved(ent)) {
+		if(!ent->saveDirty && !autosave.compacting) return;
+		G_AutosaveRecord(slot, ent);
+		ent->saveDirty = qfalse;
+		if(!autosave.saved[slot]) autosave.objects++;
+		autosave.saved[slot] = 1;
+	} else if(autosave.saved[slot]) {
+		G_AutosaveRecord(slot, NULL);
+		autosave.objects--;
+		autosave.saved[slot] = 0;
+	}
+}
+
+/*
+================
+G_AutosaveFrame
+
+Runs the autosave pass for as long as the frame budget allows
+================
+*/
+void G_AutosaveFrame(void) {
+	int start, budget;
+
+	if(cvarTrackedInt(g_autosave) <= 0) return;
+
+	if(!autosave.running) {
+		if(level.time < autosave.nextTime) return;
+		G_AutosaveStart();
+	}
+
+	budget = cvarTrackedInt(g_autosaveBudget);
+	if(budget <= 0) budget = AUTOSAVE_BUDGET;
+
+	start = trap_Milliseconds();
+	for(; autosave.cursor < level.num_entities; autosave.cursor++) {
+		if(!(autosave.cursor % AUTOSAVE_CHECK) && trap_Milliseconds() - start >= budget) {
+			G_AutosaveFlush();
+			return;
+		}
+		G_AutosaveSlot(autosave.cursor);
+	}
+
+	G_AutosaveFinish();
+}
+
+void G_AutosaveShutdown(void) {
+	if(autosave.running) G_AutosaveFlush(); // an unfinished compaction is never loaded
+	if(autosave.out && autosave.out != autosave.f) FS_Close(autosave.out);
+	if(autosave.f) FS_Close(autosave.f);
+	memset(&autosave, 0, sizeof(autosave));
+}
+
+/*
+================
+G_LoadAutosave_f
+
+Loads the newest autosave journal, falling back to the older one when
+the newest was cut short by a crash
+================
+*/
+void G_LoadAutosave_f(void) {
+	int generation[2], newest;
+
+	if(autosave.running) G_AutosaveFlush();
+
+	generation[0] = G_JournalGeneration(va(AUTOSAVE_FILE, 0));
+	generation[1] = G_JournalGeneration(va(AUTOSAVE_FILE, 1));
+	if(generation[0] < 0 && generation[1] < 0) {
+		print("No autosave found\n");
+		return;
+	}
+
+	newest = generation[1] > generation[0];
+	if(!G_LoadMapfile(va(AUTOSAVE_FILE, newest)) && generation[!newest] >= 0) {
+		print("Autosave %i is incomplete, loading the previous one\n", generation[newest]);
+		G_LoadMapfile(va(AUTOSAVE_FILE, !newest));
+	}
+
+	trap_SendServerCommand(-1, "print \"^2Map loaded!\n\"");
+}
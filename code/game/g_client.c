@@ -116,7 +116,8 @@ void SetClientViewAngle(gentity_t *ent, vec3_t angle) {
 		int cmdAngle;
 
 		cmdAngle = ANGLE2SHORT(angle[i]);
-		ent->client->ps.delta_angles[i] = cmdAngle - ent->client->pers.cmd.angles[i];
+		if(i < 2) cmdAngle -= ent->client->pers.cmd.angles[i]; // usercmd_t carries no roll
+		ent->client->ps.delta_angles[i] = cmdAngle;
 	}
 	VectorCopy(angle, ent->s.angles);
 	VectorCopy(ent->s.angles, ent->client->ps.viewangles);
@@ -329,6 +330,9 @@ void ClientBegin(int clientNum) {
 	memset(&client->ps, 0, sizeof(client->ps));
 	client->ps.eFlags = flags;
 
+	// a new client holds nothing yet, respawns keep what was sent
+	G_ResetClientSync(ent);
+
 	// locate ent at a spawn point
 	ClientSpawn(ent);
 
@@ -358,7 +362,7 @@ static void SetupCustomBot(gentity_t *bot) {
 
 	bot->health = bot->client->ps.stats[STAT_HEALTH] = bot->botspawn->health;
 
-	CopyAlloc(bot->target, bot->botspawn->target); // noire.dev bot->target
+	G_SetEntityString(bot, &bot->target, bot->botspawn->target); // noire.dev bot->target
 }
 
 void SetUnlimitedWeapons(gentity_t *ent) {
@@ -33,16 +33,60 @@ void DeathmatchScoreboardMessage(gentity_t *ent) {
 	trap_SendServerCommand(ent - g_entities, va("scores %i %i %i%s", i, level.teamScores[TEAM_RED], level.teamScores[TEAM_BLUE], string));
 }
 
+/*
+==================
+G_ResetClientSync
+
+Forgets what the client holds, the next sends carry the full state
+==================
+*/
+void G_ResetClientSync(gentity_t *ent) {
+	int i;
+
+	if(!ent->client) return;
+
+	for(i = 0; i < WEAPONS_NUM; i++) ent->client->swepSynced[i] = SYNC_UNKNOWN;
+	for(i = 0; i < GAMECVARS_NUM; i++) ent->client->gameCvarsSynced[i] = SYNC_UNKNOWN;
+	ent->client->toolgunInfoEnt = SYNC_UNKNOWN;
+}
+
+/*
+==================
+G_SendGameCvars
+
+Sends "gCvars <index> <value> ..." for the replicated cvars that changed
+==================
+*/
 void G_SendGameCvars(gentity_t *ent) {
-	char string[4096];
-	Com_sprintf(string, sizeof(string), "%i %i", mod_jumpheight, mod_gravity);
-	trap_SendServerCommand(ent - g_entities, va("gCvars %s", string));
+	char string[MAX_STRING_CHARS];
+	int values[GAMECVARS_NUM];
+	int i, len = 0;
+
+	if(ent->npcType > NT_PLAYER) return;
+
+	values[GCVAR_JUMPHEIGHT] = mod_jumpheight;
+	values[GCVAR_GRAVITY] = mod_gravity;
+
+	for(i = 0; i < GAMECVARS_NUM; i++) {
+		if(ent->client->gameCvarsSynced[i] == values[i]) continue;
+		ent->client->gameCvarsSynced[i] = values[i];
+		len += Q_snprintf(string + len, sizeof(string) - len, " %i %i", i, values[i]);
+	}
+
+	if(!len) return;
+	trap_SendServerCommand(ent - g_entities, va("gCvars%s", string));
 }
 
+/*
+==================
+G_SendSwepWeapons
+
+Sends "sweps <weapon> <status> ..." for the weapons whose status changed
+==================
+*/
 void G_SendSwepWeapons(gentity_t *ent) {
-	char string[4096] = "";
-	int i;
-	int len;
+	char string[MAX_STRING_CHARS];
+	int i, len = 0;
 
 	for(i = 1; i < WEAPONS_NUM; i++) {
 		if(ent->swep_list[i] >= WS_HAVE) {
@@ -52,19 +96,13 @@ void G_SendSwepWeapons(gentity_t *ent) {
 				ent->swep_list[i] = WS_NOAMMO; // we have weapon only
 			}
 		}
-		if(ent->swep_list[i] == WS_HAVE) {
-			Q_strcat(string, sizeof(string), va("%i ", i));
-		}
-		if(ent->swep_list[i] == WS_NOAMMO) {
-			Q_strcat(string, sizeof(string), va("%i ", i * -1)); // use -id for send WS_NOAMMO
-		}
-	}
-	len = strlen(string);
-	if(len > 0 && string[len - 1] == ' ') {
-		string[len - 1] = '\0';
+		if(ent->client->swepSynced[i] == ent->swep_list[i]) continue;
+		ent->client->swepSynced[i] = ent->swep_list[i];
+		len += Q_snprintf(string + len, sizeof(string) - len, " %i %i", i, ent->swep_list[i]);
 	}
 
-	trap_SendServerCommand(ent - g_entities, va("sweps %s", string));
+	if(!len || ent->npcType > NT_PLAYER) return;
+	trap_SendServerCommand(ent - g_entities, va("sweps%s", string));
 }
 
 void G_SendSpawnSwepWeapons(gentity_t *ent) {
@@ -545,24 +583,24 @@ static void Cmd_SpawnList_Item_f(gentity_t *ent) {
 		VectorCopy(tr.endpos, tent->s.origin);
 		tent->s.origin[2] += 25;
 		tent->classname = "sandbox_npc";
-		CopyAlloc(tent->clientname, arg02);
+		G_SetEntityString(tent, &tent->clientname, arg02);
 		tent->type = BG_FindNPCTypeID(arg03);
 		tent->skill = atof(arg04);
 		tent->health = atoi(arg05);
-		CopyAlloc(tent->message, arg06);
+		G_SetEntityString(tent, &tent->message, arg06);
 		tent->weapon = atoi(arg08);
 
 		if(!Q_stricmp(arg07, "0")) {
-			CopyAlloc(tent->target, arg02);
+			G_SetEntityString(tent, &tent->target, arg02);
 		} else {
-			CopyAlloc(tent->target, arg07);
+			G_SetEntityString(tent, &tent->target, arg07);
 		}
 
 		if(tent->health <= 0) tent->health = 100;
 
 		if(tent->skill <= 0) tent->skill = 1;
 
-		if(!Q_stricmp(tent->message, "0") || !tent->message) CopyAlloc(tent->message, tent->clientname);
+		if(!Q_stricmp(tent->message, "0") || !tent->message) G_SetEntityString(tent, &tent->message, tent->clientname);
 
 		G_AddBot(tent->clientname, tent->message, "Blue", tent);
 
@@ -755,6 +793,7 @@ commands_t cmds[] = {
     {"activate", CMD_LIVING, Cmd_ActivateTarget_f},
 
     // internal
+    {"sync", CMD_INTERMISSION, G_ResetClientSync},
     {"wp", CMD_LIVING, Cmd_Weapon_f},
     {"sl", CMD_LIVING, Cmd_SpawnList_Item_f},
     {"tm", CMD_LIVING, Cmd_Modify_Prop_f},
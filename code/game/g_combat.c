@@ -211,6 +211,7 @@ static qboolean G_EnterInCar(gentity_t *player, gentity_t *vehicle) {
 	// Activate vehicle physics
 	vehicle->think = Phys_VehiclePlayer;
 	vehicle->nextthink = level.time + 1;
+	Phys_Wake(vehicle);
 
 	return qtrue;
 }
@@ -364,6 +365,7 @@ void G_Damage(gentity_t *targ, gentity_t *inflictor, gentity_t *attacker, vec3_t
 	// do the damage
 	if(take) {
 		targ->health = targ->health - take;
+		targ->saveDirty = qtrue; // health is a saved field
 		if(targ->client) {
 			targ->client->ps.stats[STAT_HEALTH] = targ->health;
 		}
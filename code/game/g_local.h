@@ -53,7 +53,9 @@ struct gentity_s {
 
 	char *model;
 	char *model2;
-	int freetime; // level.time when the object was freed
+	int freetime;    // level.time when the object was freed
+	int stringChain; // G_EntityString allocations, freed with the entity
+	qboolean saveDirty; // changed since the autosave journal last wrote it
 
 	int eventTime; // events will be cleared EVENT_VALID_MSEC after set
 	qboolean freeAfterEvent;
@@ -195,6 +197,8 @@ struct gentity_s {
 	// Phys settings
 	int phys_weldedObjectsNum;
 	gentity_t *physParentEnt;
+	gentity_t *physChildEnt;   // first welded child
+	gentity_t *physSiblingEnt; // next child welded to the same parent
 
 	// Saved info (save)
 	vec3_t phys_relativeOrigin;
@@ -209,6 +213,10 @@ struct gentity_s {
 	void (*phys_think)(gentity_t *self);
 	float phys_bounce;
 
+	// Phys sleep
+	int phys_restTime;      // time the object came to rest on ground
+	qboolean phys_sleeping; // skipped by Phys_Frame until woken
+
 	// Save weld (sync)
 	int phys_welded; // welded
 	int phys_parent; // master
@@ -305,6 +313,12 @@ struct gclient_s {
 
 	int timeEntityInfo;
 
+	// last state sent to the client, only changes go out
+	int swepSynced[WEAPONS_NUM];
+	int gameCvarsSynced[GAMECVARS_NUM];
+	int toolgunInfoEnt;  // entity in the client's toolgun info
+	int toolgunInfoHash; // hash of the fields sent for it
+
 	gentity_t *persistantPowerup;
 	int portalID;
 	int invulnerabilityTime;
@@ -385,6 +399,11 @@ typedef struct {
 	int portalSequence;
 
 	int frameStartTime;
+
+	// freed entity slots in the order they were freed
+	int freeEntityHead; // entity number + 1, 0 when empty
+	int freeEntityTail;
+	int freeEntityNext[MAX_GENTITIES];
 } level_locals_t;
 
 typedef struct {
@@ -392,6 +411,9 @@ typedef struct {
 	void (*spawn)(gentity_t *ent);
 } spawn_t;
 
+// frame profiler scopes, PROF_FRAME takes what no other scope does
+typedef enum { PROF_FRAME, PROF_ITEMS, PROF_PHYSICS, PROF_CLIENTS, PROF_MISSILES, PROF_THINK, PROF_ENDFRAME, PROF_EXITRULES, PROF_RANKS, PROF_AUTOSAVE, PROF_AI, PROF_NUM } profileScope_t;
+
 // damage flags
 #define DAMAGE_RADIUS 0x00000001             // damage was indirect
 #define DAMAGE_NO_ARMOR 0x00000002           // armour does not protect from this damage
@@ -412,6 +434,7 @@ int BotAILoadMap(int restart);
 int BotAISetupClient(int client, struct bot_settings_s *settings);
 int BotAIShutdownClient(int client, qboolean restart);
 int AI_Frame(int time);
+void BotAIStats_f(void);
 
 // g_active.c
 void ClientThink(int clientNum);
@@ -420,6 +443,17 @@ int G_CheckWeaponAmmo(int clientNum, int wp);
 void PM_Add_SwepAmmo(int clientNum, int wp, int count);
 void ClientEndFrame(gentity_t *ent);
 
+// g_alloc.c
+char *G_EntityString(gentity_t *ent, const char *string);
+void G_SetEntityString(gentity_t *ent, char **field, const char *string);
+void G_FreeEntityStrings(gentity_t *ent);
+void G_MemoryStats_f(void);
+
+// g_autosave.c
+void G_AutosaveFrame(void);
+void G_AutosaveShutdown(void);
+void G_LoadAutosave_f(void);
+
 // g_bot.c
 qboolean G_BotConnect(int clientNum);
 void G_AddBot(char *model, char *name, char *team, gentity_t *spawn);
@@ -444,6 +478,7 @@ qboolean OnSameTeam(gentity_t *ent1, gentity_t *ent2);
 
 // g_cmds.c
 void DeathmatchScoreboardMessage(gentity_t *ent);
+void G_ResetClientSync(gentity_t *ent);
 void G_SendGameCvars(gentity_t *ent);
 void G_SendSwepWeapons(gentity_t *ent);
 void G_SendSpawnSwepWeapons(gentity_t *ent);
@@ -496,9 +531,18 @@ void Phys_HoldSetup(gentity_t *player, qboolean isPhysgun);
 void Phys_HoldFrame(gentity_t *player, vec3_t velocity, qboolean isPhysgun);
 void Phys_Disable(gentity_t *ent, vec3_t origin);
 void Phys_Enable(gentity_t *ent);
+void Phys_Wake(gentity_t *ent);
+void Phys_Weld(gentity_t *ent, gentity_t *parent);
 void Phys_Unweld(gentity_t *ent);
 void Phys_Frame(gentity_t *ent);
 
+// g_profile.c
+void G_ProfileBegin(profileScope_t scope);
+void G_ProfileEnd(void);
+void G_ProfileSwitch(profileScope_t scope);
+void G_ProfileFrame(void);
+void G_Profile_f(void);
+
 // g_sandbox.c
 void G_DieProp(gentity_t *self, gentity_t *inflictor, gentity_t *attacker, int damage, int mod);
 void SP_sandbox_npc(gentity_t *ent);
@@ -522,7 +566,12 @@ qboolean G_SpawnFloat(const char *key, const char *defaultString, float *out);
 qboolean G_SpawnInt(const char *key, const char *defaultString, int *out);
 qboolean G_SpawnVector(const char *key, const char *defaultString, float *out);
 void G_SpawnEntitiesFromString(void);
+qboolean G_LoadMapfile(const char *filename);
 void G_LoadMapfile_f(void);
+qboolean G_MapfileSaved(gentity_t *ent);
+int G_JournalHeader(byte *out, int size, int generation);
+int G_JournalGeneration(const char *filename);
+int G_JournalRecord(byte *out, int size, int slot, gentity_t *ent);
 void G_WriteMapfile_f(void);
 void G_DeleteMapfile_f(void);
 void G_ClearMap_f(void);
@@ -531,6 +580,7 @@ void G_ClearMap_f(void);
 qboolean ConsoleCommand(void);
 
 // g_utils.c
+void G_InitConfigstringIndex(void);
 int G_ModelIndex(char *name);
 int G_SoundIndex(char *name);
 void G_TeamCommand(team_t team, char *cmd);
@@ -579,6 +629,15 @@ extern gentity_t g_entities[MAX_GENTITIES];
 extern int mod_jumpheight;
 extern int mod_gravity;
 
+extern cvarHandle_t g_gametype;
+extern cvarHandle_t g_timelimit;
+extern cvarHandle_t g_fraglimit;
+extern cvarHandle_t g_gravity;
+extern cvarHandle_t g_jumpheight;
+extern cvarHandle_t g_maxEntities;
+extern cvarHandle_t g_autosave;
+extern cvarHandle_t g_autosaveBudget;
+
 #define CMD_CHEAT 0x0001
 #define CMD_CHEAT_TEAM 0x0002 // is a cheat when used on a team
 #define CMD_MESSAGE 0x0004    // sends message to others (skip when muted)
@@ -587,6 +646,8 @@ extern int mod_gravity;
 #define CMD_LIVING 0x0020
 #define CMD_INTERMISSION 0x0040 // valid during intermission
 
+#define SYNC_UNKNOWN MIN_QINT // client state must be resent in full
+
 typedef struct {
 	char *cmdName;
 	int cmdFlags;
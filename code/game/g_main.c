@@ -12,10 +12,20 @@ int SourceTechEntityList[MAX_GENTITIES];
 int mod_jumpheight;
 int mod_gravity;
 
+cvarHandle_t g_gametype;
+cvarHandle_t g_timelimit;
+cvarHandle_t g_fraglimit;
+cvarHandle_t g_gravity;
+cvarHandle_t g_jumpheight;
+cvarHandle_t g_maxEntities;
+cvarHandle_t g_autosave;
+cvarHandle_t g_autosaveBudget;
+
 static void G_InitGame(int levelTime, int randomSeed, int restart);
 static void G_RunFrame(int levelTime);
 static void G_ShutdownGame(int restart);
 static void CheckExitRules(void);
+static int G_ProfileAI(int levelTime);
 
 /*
 ================
@@ -37,7 +47,7 @@ intptr_t vmMain(int command, int arg0, int arg1, int arg2) {
 	case GAME_CLIENT_COMMAND: ClientCommand(arg0); return 0;
 	case GAME_RUN_FRAME: G_RunFrame(arg0); return 0;
 	case GAME_CONSOLE_COMMAND: return ConsoleCommand();
-	case BOTAI_START_FRAME: return AI_Frame(arg0);
+	case BOTAI_START_FRAME: return G_ProfileAI(arg0);
 	case GETVMCONTEXT: VMContext(&vmargs, &vmresult); return 0;
 	case VMCALL: VMCall(arg0); return 0;
 	default: err("game.qvm: unknown command"); break;
@@ -93,6 +103,24 @@ static void G_FindTeams(void) {
 	print("%i teams with %i entities\n", c, c2);
 }
 
+/*
+=================
+G_TrackCvars
+
+Cvars read every frame
+=================
+*/
+static void G_TrackCvars(void) {
+	g_gametype = cvarTrack("g_gametype");
+	g_timelimit = cvarTrack("g_timelimit");
+	g_fraglimit = cvarTrack("g_fraglimit");
+	g_gravity = cvarTrack("g_gravity");
+	g_jumpheight = cvarTrack("g_jumpheight");
+	g_maxEntities = cvarTrack("g_maxEntities");
+	g_autosave = cvarTrack("g_autosave");
+	g_autosaveBudget = cvarTrack("g_autosaveBudget");
+}
+
 /*
 =================
 G_CheckCvars
@@ -120,8 +148,12 @@ static void G_InitGame(int levelTime, int randomSeed, int restart) {
 	srand(randomSeed);
 
 	ST_RegisterCvars();
+	cvarRegister("g_autosave", "0", CVAR_ARCHIVE); // seconds between autosave passes, 0 is off
+	cvarRegister("g_autosaveBudget", "2", CVAR_ARCHIVE);
+	G_TrackCvars();
 	G_CheckCvars();
 	G_InitMemory();
+	G_InitConfigstringIndex();
 
 	// set some level globals
 	memset(&level, 0, sizeof(level));
@@ -188,6 +220,8 @@ static void G_ShutdownGame(int restart) {
 		}
 	}
 
+	G_AutosaveShutdown();
+
 	// write all the client session data so we can get it back
 	G_WriteSessionData();
 	BotAIShutdown(restart);
@@ -281,6 +315,8 @@ void CalculateRanks(void) {
 	int newScore;
 	gclient_t *cl;
 
+	G_ProfileBegin(PROF_RANKS);
+
 	level.follow1 = -1;
 	level.follow2 = -1;
 	level.numConnectedClients = 0;
@@ -368,6 +404,8 @@ void CalculateRanks(void) {
 	if(level.intermissiontime) {
 		SendScoreboardMessageToAllClients();
 	}
+
+	G_ProfileEnd();
 }
 
 /*
@@ -609,7 +647,7 @@ static qboolean ScoreIsTied(void) {
 		return qfalse;
 	}
 
-	if(cvarInt("g_gametype") >= GT_TEAM) {
+	if(cvarTrackedInt(g_gametype) >= GT_TEAM) {
 		return level.teamScores[TEAM_RED] == level.teamScores[TEAM_BLUE];
 	}
 
@@ -660,8 +698,8 @@ static void CheckExitRules(void) {
 		return;
 	}
 
-	if(cvarInt("g_timelimit")) {
-		if(level.time - level.startTime >= cvarInt("g_timelimit") * 60000) {
+	if(cvarTrackedInt(g_timelimit)) {
+		if(level.time - level.startTime >= cvarTrackedInt(g_timelimit) * 60000) {
 			trap_SendServerCommand(-1, "print \"Timelimit hit.\n\"");
 			LevelExit();
 			return;
@@ -672,14 +710,14 @@ static void CheckExitRules(void) {
 		return;
 	}
 
-	if(cvarInt("g_gametype") <= GT_TEAM && cvarInt("g_fraglimit")) {
-		if(level.teamScores[TEAM_RED] >= cvarInt("g_fraglimit")) {
+	if(cvarTrackedInt(g_gametype) <= GT_TEAM && cvarTrackedInt(g_fraglimit)) {
+		if(level.teamScores[TEAM_RED] >= cvarTrackedInt(g_fraglimit)) {
 			trap_SendServerCommand(-1, "print \"Red hit the fraglimit.\n\"");
 			LevelExit();
 			return;
 		}
 
-		if(level.teamScores[TEAM_BLUE] >= cvarInt("g_fraglimit")) {
+		if(level.teamScores[TEAM_BLUE] >= cvarTrackedInt(g_fraglimit)) {
 			trap_SendServerCommand(-1, "print \"Blue hit the fraglimit.\n\"");
 			LevelExit();
 			return;
@@ -694,7 +732,7 @@ static void CheckExitRules(void) {
 				continue;
 			}
 
-			if(cl->ps.persistant[PERS_SCORE] >= cvarInt("g_fraglimit")) {
+			if(cl->ps.persistant[PERS_SCORE] >= cvarTrackedInt(g_fraglimit)) {
 				LevelExit();
 				trap_SendServerCommand(-1, va("print \"%s" S_COLOR_WHITE " hit the fraglimit.\n\"", cl->pers.netname));
 				return;
@@ -756,8 +794,8 @@ Sends game cvars to client
 ================
 */
 static void G_UpdateGameCvars(void) {
-	mod_jumpheight = cvarInt("g_jumpheight");
-	mod_gravity = cvarFloat("g_gravity");
+	mod_jumpheight = cvarTrackedInt(g_jumpheight);
+	mod_gravity = cvarTrackedFloat(g_gravity);
 }
 
 /*
@@ -770,7 +808,6 @@ Advances the non-player objects in the world
 static void G_RunFrame(int levelTime) {
 	int i;
 	gentity_t *ent;
-	int start, end;
 
 	// if we are waiting for the level to restart, do nothing
 	if(level.restarted) return;
@@ -779,8 +816,13 @@ static void G_RunFrame(int levelTime) {
 	level.previousTime = level.time;
 	level.time = levelTime;
 
+	G_ProfileFrame();
+	G_ProfileBegin(PROF_FRAME);
+
+	ST_UpdateCvars();
+
 	// go through all allocated objects
-	start = trap_Milliseconds();
+	G_ProfileBegin(PROF_THINK);
 	ent = &g_entities[0];
 	for(i = 0; i < level.num_entities; i++, ent++) {
 		if(!ent->inuse) continue;
@@ -807,43 +849,72 @@ static void G_RunFrame(int levelTime) {
 		if(!ent->r.linked && ent->neverFree) continue;
 
 		if(ent->s.eType == ET_ITEM && !ent->sandboxObject || ent->physicsObject && !ent->sandboxObject) {
+			G_ProfileSwitch(PROF_ITEMS);
 			G_RunItem(ent);
 			continue;
 		}
 
 		if(ent->s.eType == ET_ITEM && ent->sandboxObject || ent->sandboxObject) {
+			G_ProfileSwitch(PROF_PHYSICS);
 			Phys_Frame(ent);
 			continue;
 		}
 
 		if(i < MAX_CLIENTS) {
+			G_ProfileSwitch(PROF_CLIENTS);
 			G_RunClient(ent);
 			continue;
 		}
 
 		if(ent->s.eType == ET_MISSILE) {
+			G_ProfileSwitch(PROF_MISSILES);
 			G_RunMissile(ent);
+		} else {
+			G_ProfileSwitch(PROF_THINK);
 		}
 
 		G_RunThink(ent);
 	}
+	G_ProfileEnd();
 
-	end = trap_Milliseconds();
-
-	start = trap_Milliseconds();
 	// perform final fixups on the players
+	G_ProfileBegin(PROF_ENDFRAME);
 	ent = &g_entities[0];
 	for(i = 0; i < level.maxclients; i++, ent++) {
 		if(ent->inuse) {
 			ClientEndFrame(ent);
 		}
 	}
-	end = trap_Milliseconds();
+	G_ProfileEnd();
 
 	// see if it is time to end the level
+	G_ProfileBegin(PROF_EXITRULES);
 	CheckExitRules();
+	G_ProfileEnd();
 
 	G_UpdateGameCvars();
 
+	G_ProfileBegin(PROF_AUTOSAVE);
+	G_AutosaveFrame();
+	G_ProfileEnd();
+
+	G_ProfileEnd();
+
 	level.frameStartTime = trap_Milliseconds();
 }
+
+/*
+================
+G_ProfileAI
+
+The bot frame runs after the server frame and counts towards it
+================
+*/
+static int G_ProfileAI(int levelTime) {
+	int result;
+
+	G_ProfileBegin(PROF_AI);
+	result = AI_Frame(levelTime);
+	G_ProfileEnd();
+	return result;
+}
@@ -24,6 +24,7 @@ void Phys_VehiclePlayer(gentity_t *self) {
 		self->sb_coll = CONTENTS_SOLID;
 		self->s.pos.trType = TR_GRAVITY;
 		self->s.pos.trTime = level.time;
+		Phys_Wake(self); // clients extrapolate the fall, so the server has to run it
 		ClientUserinfoChanged(self->parent->s.clientNum);
 		VectorSet(self->parent->r.mins, -15, -15, -24);
 		VectorSet(self->parent->r.maxs, 15, 15, 32);
@@ -31,7 +32,7 @@ void Phys_VehiclePlayer(gentity_t *self) {
 		self->parent->client->vehicleNum = 0;
 		self->s.legsAnim = 0;
 		self->s.generic1 = 0; // smooth vehicles
-		self->parent->client->ps.gravity = cvarFloat("g_gravity");
+		self->parent->client->ps.gravity = cvarTrackedFloat(g_gravity);
 		return;
 	}
 
@@ -53,6 +54,7 @@ void Phys_VehiclePlayer(gentity_t *self) {
 	if(engine10hook(sqrt(self->parent->client->ps.velocity[0] * self->parent->client->ps.velocity[0] + self->parent->client->ps.velocity[1] * self->parent->client->ps.velocity[1]), 0, 900) <= 10) {             // 900 is car speed
 		self->s.legsAnim = engine10hook(sqrt(self->parent->client->ps.velocity[0] * self->parent->client->ps.velocity[0] + self->parent->client->ps.velocity[1] * self->parent->client->ps.velocity[1]), 0, 900); // 900 is car speed
 	}
+	if(!VectorCompare(self->parent->r.currentOrigin, self->r.currentOrigin) || !VectorCompare(self->s.apos.trBase, self->s.angles)) self->saveDirty = qtrue;
 	VectorCopy(self->parent->r.currentOrigin, self->r.currentOrigin);
 	self->parent->client->ps.stats[STAT_VEHICLEHP] = self->health; // VEHICLE-SYSTEM: vehicle's hp instead player
 	self->s.generic1 = self->parent->s.clientNum + 1;              // smooth vehicles
@@ -226,6 +228,7 @@ void Phys_HoldSetup(gentity_t *player, qboolean isPhysgun) {
 
 	ent->isGrabbed = qtrue;
 	if(!ent->client) {
+		Phys_Wake(ent);
 		if(isPhysgun) {
 			ent->grabNewPhys = PHYS_DYNAMIC;
 		}
@@ -244,22 +247,10 @@ Check and calculate welded objects to this object
 */
 static void Phys_CheckWeldedEntities(gentity_t *ent) {
 	gentity_t *object;
-	int i = 0;
-	int j = 0;
 
-	if(!ent->phys_weldedObjectsNum) {
-		return;
-	}
-
-	for(i = 0; i < MAX_GENTITIES; i++) {
-		object = &g_entities[i];
-		if(ent == object->physParentEnt) {
-			trap_UnlinkEntity(object);
-			j++;
-		}
+	for(object = ent->physChildEnt; object; object = object->physSiblingEnt) {
+		trap_UnlinkEntity(object);
 	}
-
-	ent->phys_weldedObjectsNum = j;
 }
 
 /*
@@ -271,85 +262,78 @@ Restores welded objects to this object
 */
 static void Phys_RestoreWeldedEntities(gentity_t *ent) {
 	gentity_t *object;
-	int i = 0;
-
-	if(!ent->phys_weldedObjectsNum) {
-		return;
-	}
-
-	for(i = 0; i < MAX_GENTITIES; i++) {
-		object = &g_entities[i];
-		if(ent == object->physParentEnt) {
-			vec3_t forward, right, up;
-			vec3_t rotatedOffset, finalPos;
-			vec3_t entForward, entRight, entUp;
-			vec3_t relForward, relRight, relUp;
-			vec3_t newForward, newRight, newUp;
-			float matrix[3][3];
-			vec3_t newAngles;
-
-			// Origin
-			AngleVectors(ent->s.apos.trBase, forward, right, up);
-			rotatedOffset[0] = forward[0] * object->phys_relativeOrigin[0] + right[0] * object->phys_relativeOrigin[1] + up[0] * object->phys_relativeOrigin[2];
-			rotatedOffset[1] = forward[1] * object->phys_relativeOrigin[0] + right[1] * object->phys_relativeOrigin[1] + up[1] * object->phys_relativeOrigin[2];
-			rotatedOffset[2] = forward[2] * object->phys_relativeOrigin[0] + right[2] * object->phys_relativeOrigin[1] + up[2] * object->phys_relativeOrigin[2];
-
-			VectorAdd(ent->r.currentOrigin, rotatedOffset, finalPos);
-
-			VectorCopy(finalPos, object->s.origin);
-			VectorCopy(finalPos, object->r.currentOrigin);
-			VectorCopy(finalPos, object->s.pos.trBase);
-
-			// Angles
-			AngleVectors(ent->s.apos.trBase, entForward, entRight, entUp);
-
-			VectorCopy(object->phys_rv_0, relForward);
-			VectorCopy(object->phys_rv_1, relRight);
-			VectorCopy(object->phys_rv_2, relUp);
-
-			newForward[0] = entForward[0] * relForward[0] + entRight[0] * relForward[1] + entUp[0] * relForward[2];
-			newForward[1] = entForward[1] * relForward[0] + entRight[1] * relForward[1] + entUp[1] * relForward[2];
-			newForward[2] = entForward[2] * relForward[0] + entRight[2] * relForward[1] + entUp[2] * relForward[2];
-
-			newRight[0] = entForward[0] * relRight[0] + entRight[0] * relRight[1] + entUp[0] * relRight[2];
-			newRight[1] = entForward[1] * relRight[0] + entRight[1] * relRight[1] + entUp[1] * relRight[2];
-			newRight[2] = entForward[2] * relRight[0] + entRight[2] * relRight[1] + entUp[2] * relRight[2];
-
-			newUp[0] = entForward[0] * relUp[0] + entRight[0] * relUp[1] + entUp[0] * relUp[2];
-			newUp[1] = entForward[1] * relUp[0] + entRight[1] * relUp[1] + entUp[1] * relUp[2];
-			newUp[2] = entForward[2] * relUp[0] + entRight[2] * relUp[1] + entUp[2] * relUp[2];
-
-			OrthogonalizeMatrix(newForward, newRight, newUp);
-
-			matrix[0][0] = newForward[0]; // X forward
-			matrix[0][1] = newRight[0];   // X right
-			matrix[0][2] = newUp[0];      // X up
-
-			matrix[1][0] = newForward[1]; // Y forward
-			matrix[1][1] = newRight[1];   // Y right
-			matrix[1][2] = newUp[1];      // Y up
-
-			matrix[2][0] = newForward[2]; // Z forward
-			matrix[2][1] = newRight[2];   // Z right
-			matrix[2][2] = newUp[2];      // Z up
-
-			AxisToAngles(matrix, newAngles);
-
-			newAngles[2] -= 180; // it's work well
-
-			VectorCopy(newAngles, object->s.angles);
-			VectorCopy(newAngles, object->s.apos.trBase);
-			VectorCopy(newAngles, object->r.currentAngles);
-
-			// Disable phys
-			object->s.pos.trType = TR_STATIONARY;
-			object->sb_phys = PHYS_STATIC;
-			object->s.otherEntityNum = ent->s.number;
-			VectorCopy(object->phys_relativeOrigin, object->s.origin2);
-			Phys_Disable(object, object->s.pos.trBase);
-
-			trap_LinkEntity(object);
-		}
+	vec3_t forward, right, up;
+	vec3_t rotatedOffset, finalPos;
+	vec3_t entForward, entRight, entUp;
+	vec3_t relForward, relRight, relUp;
+	vec3_t newForward, newRight, newUp;
+	float matrix[3][3];
+	vec3_t newAngles;
+
+	for(object = ent->physChildEnt; object; object = object->physSiblingEnt) {
+		// Origin
+		AngleVectors(ent->s.apos.trBase, forward, right, up);
+		rotatedOffset[0] = forward[0] * object->phys_relativeOrigin[0] + right[0] * object->phys_relativeOrigin[1] + up[0] * object->phys_relativeOrigin[2];
+		rotatedOffset[1] = forward[1] * object->phys_relativeOrigin[0] + right[1] * object->phys_relativeOrigin[1] + up[1] * object->phys_relativeOrigin[2];
+		rotatedOffset[2] = forward[2] * object->phys_relativeOrigin[0] + right[2] * object->phys_relativeOrigin[1] + up[2] * object->phys_relativeOrigin[2];
+
+		VectorAdd(ent->r.currentOrigin, rotatedOffset, finalPos);
+
+		if(!VectorCompare(finalPos, object->s.origin)) object->saveDirty = qtrue;
+		VectorCopy(finalPos, object->s.origin);
+		VectorCopy(finalPos, object->r.currentOrigin);
+		VectorCopy(finalPos, object->s.pos.trBase);
+
+		// Angles
+		AngleVectors(ent->s.apos.trBase, entForward, entRight, entUp);
+
+		VectorCopy(object->phys_rv_0, relForward);
+		VectorCopy(object->phys_rv_1, relRight);
+		VectorCopy(object->phys_rv_2, relUp);
+
+		newForward[0] = entForward[0] * relForward[0] + entRight[0] * relForward[1] + entUp[0] * relForward[2];
+		newForward[1] = entForward[1] * relForward[0] + entRight[1] * relForward[1] + entUp[1] * relForward[2];
+		newForward[2] = entForward[2] * relForward[0] + entRight[2] * relForward[1] + entUp[2] * relForward[2];
+
+		newRight[0] = entForward[0] * relRight[0] + entRight[0] * relRight[1] + entUp[0] * relRight[2];
+		newRight[1] = entForward[1] * relRight[0] + entRight[1] * relRight[1] + entUp[1] * relRight[2];
+		newRight[2] = entForward[2] * relRight[0] + entRight[2] * relRight[1] + entUp[2] * relRight[2];
+
+		newUp[0] = entForward[0] * relUp[0] + entRight[0] * relUp[1] + entUp[0] * relUp[2];
+		newUp[1] = entForward[1] * relUp[0] + entRight[1] * relUp[1] + entUp[1] * relUp[2];
+		newUp[2] = entForward[2] * relUp[0] + entRight[2] * relUp[1] + entUp[2] * relUp[2];
+
+		OrthogonalizeMatrix(newForward, newRight, newUp);
+
+		matrix[0][0] = newForward[0]; // X forward
+		matrix[0][1] = newRight[0];   // X right
+		matrix[0][2] = newUp[0];      // X up
+
+		matrix[1][0] = newForward[1]; // Y forward
+		matrix[1][1] = newRight[1];   // Y right
+		matrix[1][2] = newUp[1];      // Y up
+
+		matrix[2][0] = newForward[2]; // Z forward
+		matrix[2][1] = newRight[2];   // Z right
+		matrix[2][2] = newUp[2];      // Z up
+
+		AxisToAngles(matrix, newAngles);
+
+		newAngles[2] -= 180; // it's work well
+
+		if(!VectorCompare(newAngles, object->s.angles)) object->saveDirty = qtrue;
+		VectorCopy(newAngles, object->s.angles);
+		VectorCopy(newAngles, object->s.apos.trBase);
+		VectorCopy(newAngles, object->r.currentAngles);
+
+		// Disable phys
+		object->s.pos.trType = TR_STATIONARY;
+		object->sb_phys = PHYS_STATIC;
+		object->s.otherEntityNum = ent->s.number;
+		VectorCopy(object->phys_relativeOrigin, object->s.origin2);
+		Phys_Disable(object, object->s.pos.trBase);
+
+		trap_LinkEntity(object);
 	}
 }
 
@@ -455,6 +439,9 @@ void Phys_Enable(gentity_t *ent) {
 	if(ent->sb_phys == PHYS_STATIC || !ent->sandboxObject) { // if it's static object, not turn phys
 		return;
 	}
+	if(ent->phys_sleeping || ent->s.pos.trType == TR_STATIONARY) {
+		Phys_Wake(ent); // starts moving, props resting on it must follow
+	}
 	VectorCopy(ent->r.currentOrigin, ent->s.pos.trBase); // restore client origin from physics origin
 	if(ent->phys_inWater) {
 		ent->s.pos.trType = TR_GRAVITY_WATER;
@@ -467,6 +454,127 @@ void Phys_Enable(gentity_t *ent) {
 	ent->phys_think = NULL;
 }
 
+static int physWakeQueue[MAX_GENTITIES];
+static int physWakeTail;
+
+// queues the sleeping groups touching one object
+static void Phys_WakeTouching(gentity_t *ent) {
+	static int touch[MAX_GENTITIES];
+	int i, num;
+	vec3_t mins, maxs;
+	gentity_t *object;
+
+	if(!ent->r.linked) return;
+
+	for(i = 0; i < 3; i++) {
+		mins[i] = ent->r.absmin[i] - PHYS_WAKERANGE;
+		maxs[i] = ent->r.absmax[i] + PHYS_WAKERANGE;
+	}
+	num = trap_EntitiesInBox(mins, maxs, touch, MAX_GENTITIES);
+
+	for(i = 0; i < num; i++) {
+		object = &g_entities[touch[i]];
+		if(object->physParentEnt) object = object->physParentEnt;
+		if(!object->phys_sleeping) continue;
+
+		object->phys_sleeping = qfalse;
+		object->phys_restTime = 0;
+		physWakeQueue[physWakeTail++] = object->s.number;
+	}
+}
+
+/*
+================
+Phys_Wake
+
+Wakes sleeping object together with every sleeping prop touching it,
+a welded group wakes what touches any of its members
+================
+*/
+void Phys_Wake(gentity_t *ent) {
+	int head = 0;
+	gentity_t *root, *child;
+
+	if(!ent->sandboxObject) return;
+	if(ent->physParentEnt) ent = ent->physParentEnt;
+
+	ent->phys_sleeping = qfalse;
+	ent->phys_restTime = 0;
+	physWakeTail = 0;
+	physWakeQueue[physWakeTail++] = ent->s.number;
+
+	while(head < physWakeTail) {
+		root = &g_entities[physWakeQueue[head++]];
+		Phys_WakeTouching(root);
+		for(child = root->physChildEnt; child; child = child->physSiblingEnt) Phys_WakeTouching(child);
+	}
+}
+
+/*
+================
+Phys_CheckSleep
+
+Puts object to sleep after it rests on ground for PHYS_SLEEPTIME
+================
+*/
+static void Phys_CheckSleep(gentity_t *ent) {
+	if(ent->isGrabbed || ent->phys_nextthink || ent->phys_inSolid || ent->think == Phys_VehiclePlayer) {
+		ent->phys_restTime = 0;
+		return;
+	}
+
+	if(!ent->phys_restTime) {
+		ent->phys_restTime = level.time;
+		return;
+	}
+
+	if(level.time - ent->phys_restTime >= PHYS_SLEEPTIME) {
+		ent->phys_sleeping = qtrue;
+	}
+}
+
+/*
+================
+Phys_UnlinkWeld
+
+Removes object from the child list of its weld parent
+================
+*/
+static void Phys_UnlinkWeld(gentity_t *ent) {
+	gentity_t **link;
+
+	if(!ent->physParentEnt) return;
+
+	for(link = &ent->physParentEnt->physChildEnt; *link; link = &(*link)->physSiblingEnt) {
+		if(*link == ent) {
+			*link = ent->physSiblingEnt;
+			ent->physParentEnt->phys_weldedObjectsNum--;
+			break;
+		}
+	}
+
+	ent->physParentEnt = NULL;
+	ent->physSiblingEnt = NULL;
+}
+
+/*
+================
+Phys_Weld
+
+Welds physic object to parent object
+================
+*/
+void Phys_Weld(gentity_t *ent, gentity_t *parent) {
+	if(ent == parent) return;
+
+	Phys_UnlinkWeld(ent);
+
+	ent->physParentEnt = parent;
+	ent->physSiblingEnt = parent->physChildEnt;
+	parent->physChildEnt = ent;
+	parent->phys_weldedObjectsNum++;
+}
+
 /*
 ================
 Phys_Unweld
@@ -476,40 +584,33 @@ Remove weld from physic object
 */
 void Phys_Unweld(gentity_t *ent) {
 	gentity_t *object;
-	int i;
-	if(ent->phys_weldedObjectsNum) {
-		for(i = 0; i < MAX_GENTITIES; i++) {
-			object = &g_entities[i];
-			if(ent->s.number == object->physParentEnt->s.number) {
-				ent->s.pos.trType = TR_GRAVITY;
-				ent->s.pos.trTime = level.time;
-				ent->sb_phys = PHYS_DYNAMIC;
-				Phys_Enable(ent);
-				object->s.pos.trType = TR_GRAVITY;
-				object->s.pos.trTime = level.time;
-				object->sb_phys = PHYS_DYNAMIC;
-				Phys_Enable(object);
-				object->physParentEnt = NULL;
-				VectorClear(object->phys_relativeOrigin);
-				VectorClear(object->phys_rv_0);
-				VectorClear(object->phys_rv_1);
-				VectorClear(object->phys_rv_2);
-			}
-		}
-		return;
-	}
 
+	if(!ent->physChildEnt && !ent->physParentEnt) return;
+
+	ent->s.pos.trType = TR_GRAVITY;
+	ent->s.pos.trTime = level.time;
+	ent->sb_phys = PHYS_DYNAMIC;
+	Phys_Enable(ent);
+
+	// a welded group can also hang off a parent of its own
 	if(ent->physParentEnt) {
-		ent->s.pos.trType = TR_GRAVITY;
-		ent->s.pos.trTime = level.time;
-		ent->sb_phys = PHYS_DYNAMIC;
-		Phys_Enable(ent);
-		ent->physParentEnt = NULL;
+		Phys_UnlinkWeld(ent);
 		VectorClear(ent->phys_relativeOrigin);
 		VectorClear(ent->phys_rv_0);
 		VectorClear(ent->phys_rv_1);
 		VectorClear(ent->phys_rv_2);
-		return;
+	}
+
+	while((object = ent->physChildEnt) != NULL) {
+		Phys_UnlinkWeld(object);
+		object->s.pos.trType = TR_GRAVITY;
+		object->s.pos.trTime = level.time;
+		object->sb_phys = PHYS_DYNAMIC;
+		Phys_Enable(object);
+		VectorClear(object->phys_relativeOrigin);
+		VectorClear(object->phys_rv_0);
+		VectorClear(object->phys_rv_1);
+		VectorClear(object->phys_rv_2);
 	}
 }
 
@@ -674,7 +775,7 @@ Phys model for physic object
 static void Phys_SelectPhysModel(gentity_t *ent) {
 	float impactForceFixed;
 
-	impactForceFixed = sqrt(ent->s.pos.trDelta[0] * ent->s.pos.trDelta[0] + ent->s.pos.trDelta[1] * ent->s.pos.trDelta[1] + cvarInt("g_gravity") * cvarInt("g_gravity"));
+	impactForceFixed = sqrt(ent->s.pos.trDelta[0] * ent->s.pos.trDelta[0] + ent->s.pos.trDelta[1] * ent->s.pos.trDelta[1] + cvarTrackedInt(g_gravity) * cvarTrackedInt(g_gravity));
 
 	impactForceFixed *= ent->s.angles2[A2_MASS];
 
@@ -765,6 +866,8 @@ static qboolean Phys_UpdateState(gentity_t *ent) {
 		VectorClear(ent->s.pos.trDelta);
 	}
 
+	if(!VectorCompare(ent->s.apos.trBase, ent->s.angles) || !VectorCompare(ent->r.currentOrigin, ent->s.origin)) ent->saveDirty = qtrue; // moved since the last save
+
 	// Update server and phys rotate
 	VectorCopy(ent->s.apos.trBase, ent->s.angles); // update server angles from client angles
 	if(ent->s.pos.trType == TR_STATIONARY) {
@@ -781,6 +884,7 @@ static qboolean Phys_UpdateState(gentity_t *ent) {
 			Phys_RestoreWeldedEntities(ent);
 			G_RunThink(ent);
 			Phys_RunPhysThink(ent);
+			Phys_CheckSleep(ent);
 			return qfalse;
 		} else {
 			Phys_Enable(ent);
@@ -876,6 +980,8 @@ static void Phys_Impact(gentity_t *ent, trace_t *tr) {
 						VectorAdd(hit->client->ps.velocity, impactVector, hit->client->ps.velocity); // Transfer velocity from the prop to the hit player
 					}
 				}
+			} else if(!hit->client && hit->phys_sleeping && ent->s.pos.trType != TR_STATIONARY) {
+				Phys_Wake(hit); // too soft to push it, but it has to react again
 			}
 			if(impactForceAll > PHYS_DAMAGESENS && !tr->startsolid) {
 				if(hit->grabbedEntity != ent) {
@@ -914,20 +1020,36 @@ void Phys_Frame(gentity_t *ent) {
 	}
 
 	if(ent->physParentEnt) {
+		if(ent->phys_welded != ent->physParentEnt->s.number) ent->saveDirty = qtrue;
 		ent->phys_welded = ent->physParentEnt->s.number;
 		return;
 	} else {
+		if(ent->phys_welded) ent->saveDirty = qtrue;
 		ent->phys_welded = 0;
 		ent->s.otherEntityNum = 0;
 		VectorClear(ent->s.origin2);
 	}
 
+	if(ent->phys_parent != (ent->phys_weldedObjectsNum ? ent->s.number : 0)) ent->saveDirty = qtrue;
 	if(ent->phys_weldedObjectsNum) {
 		ent->phys_parent = ent->s.number;
 	} else {
 		ent->phys_parent = 0;
 	}
 
+	// Sleeping objects only think until something wakes them, the think
+	// can still move them and that skips the check in Phys_UpdateState
+	if(ent->phys_sleeping) {
+		VectorCopy(ent->r.currentOrigin, origin);
+		G_RunThink(ent);
+		if(!VectorCompare(origin, ent->r.currentOrigin) || !VectorCompare(ent->s.apos.trBase, ent->s.angles)) {
+			VectorCopy(ent->r.currentOrigin, ent->s.origin); // update origin for save
+			VectorCopy(ent->s.apos.trBase, ent->s.angles);
+			ent->saveDirty = qtrue;
+		}
+		return;
+	}
+
 	// Unlink the entity so that it won't interact with other entities during the calculation
 	trap_UnlinkEntity(ent);
 	Phys_CheckWeldedEntities(ent);
@@ -935,6 +1057,7 @@ void Phys_Frame(gentity_t *ent) {
 	if(!Phys_UpdateState(ent)) { // disable physics and update state
 		return;
 	}
+	ent->phys_restTime = 0;
 
 	// Check phys models
 	Phys_SelectPhysModel(ent);
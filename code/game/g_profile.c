@@ -0,0 +1,167 @@
+// Copyright (C) 2023-2025 Noire.dev
+// OpenSandbox — GPLv2; see LICENSE for details.
+
+#include "../shared/javascript.h"
+
+/*
+====================
+Frame profiler
+
+Server frames are split into named scopes with G_ProfileBegin/End, time
+goes to the innermost open scope. G_ProfileSwitch replaces the innermost
+scope and only reads the clock when the scope changes, so the entity loop
+pays for a clock read only where the entity kinds alternate. The last
+PROFILE_FRAMES frames and the PROFILE_WORST slowest ones are kept for the
+profile command.
+====================
+*/
+
+#define PROFILE_FRAMES 512
+#define PROFILE_WORST 8
+#define PROFILE_DEPTH 8
+#define PROFILE_BUCKETS 8 // 0, 1, 2-3, 4-7, 8-15, 16-31, 32-63, 64+ msec
+
+typedef struct {
+	int time;  // level.time of the frame
+	int total; // msec
+	unsigned short scopes[PROF_NUM];
+} profileFrame_t;
+
+static const char *profileNames[PROF_NUM] = {"frame", "items", "physics", "clients", "missiles", "think", "endframe", "exitrules", "ranks", "autosave", "ai"};
+
+static struct {
+	profileFrame_t frame; // frame being recorded
+	profileFrame_t window[PROFILE_FRAMES];
+	int numFrames; // frames recorded, the window holds the last ones
+	profileFrame_t worst[PROFILE_WORST];
+	int numWorst;
+
+	int stack[PROFILE_DEPTH];
+	int depth;
+	int last; // msec of the last scope change
+} profile;
+
+static void G_ProfileCharge(void) {
+	int now;
+
+	now = trap_Milliseconds();
+	if(profile.depth) profile.frame.scopes[profile.stack[profile.depth - 1]] += now - profile.last;
+	profile.last = now;
+}
+
+void G_ProfileBegin(profileScope_t scope) {
+	G_ProfileCharge();
+	if(profile.depth < PROFILE_DEPTH) profile.stack[profile.depth] = scope;
+	profile.depth++;
+}
+
+void G_ProfileEnd(void) {
+	if(!profile.depth) return;
+	if(profile.depth <= PROFILE_DEPTH) G_ProfileCharge();
+	profile.depth--;
+}
+
+void G_ProfileSwitch(profileScope_t scope) {
+	if(!profile.depth || profile.depth > PROFILE_DEPTH) return;
+	if(profile.stack[profile.depth - 1] == scope) return;
+
+	G_ProfileCharge();
+	profile.stack[profile.depth - 1] = scope;
+}
+
+/*
+================
+G_ProfileFrame
+
+Stores the last frame, including the AI frame that ran after it,
+and starts recording the next one
+================
+*/
+void G_ProfileFrame(void) {
+	profileFrame_t *frame = &profile.frame;
+	int i, slot;
+
+	if(frame->time) {
+		frame->total = 0;
+		for(i = 0; i < PROF_NUM; i++) frame->total += frame->scopes[i];
+
+		profile.window[profile.numFrames % PROFILE_FRAMES] = *frame;
+		profile.numFrames++;
+
+		// keep the slowest frames, sorted
+		for(slot = profile.numWorst; slot > 0 && profile.worst[slot - 1].total < frame->total; slot--) {
+			if(slot < PROFILE_WORST) profile.worst[slot] = profile.worst[slot - 1];
+		}
+		if(slot < PROFILE_WORST) {
+			profile.worst[slot] = *frame;
+			if(profile.numWorst < PROFILE_WORST) profile.numWorst++;
+		}
+	}
+
+	memset(frame, 0, sizeof(*frame));
+	frame->time = level.time;
+}
+
+static int G_ProfileBucket(int msec) {
+	int bucket;
+
+	for(bucket = 0; msec && bucket < PROFILE_BUCKETS - 1; bucket++) msec >>= 1;
+	return bucket;
+}
+
+/*
+================
+G_Profile_f
+
+profile [reset]
+Prints the average, peak and histogram of every scope over the last
+frames, then the breakdown of the slowest frames
+================
+*/
+void G_Profile_f(void) {
+	char arg[16];
+	profileFrame_t *frame;
+	int histogram[PROFILE_BUCKETS];
+	int i, j, count, total, peak;
+	char *line;
+
+	trap_Argv(1, arg, sizeof(arg));
+	if(!Q_stricmp(arg, "reset")) {
+		memset(profile.window, 0, sizeof(profile.window));
+		memset(profile.worst, 0, sizeof(profile.worst));
+		profile.numFrames = profile.numWorst = 0;
+		return;
+	}
+
+	count = profile.numFrames < PROFILE_FRAMES ? profile.numFrames : PROFILE_FRAMES;
+	if(!count) {
+		print("No frames profiled\n");
+		return;
+	}
+
+	print("last %i frames, msec    avg  peak |     0     1   2-3   4-7  8-15 16-31 32-63   64+\n", count);
+	for(i = 0; i < PROF_NUM; i++) {
+		total = peak = 0;
+		memset(histogram, 0, sizeof(histogram));
+		for(j = 0; j < count; j++) {
+			frame = &profile.window[j];
+			total += frame->scopes[i];
+			if(frame->scopes[i] > peak) peak = frame->scopes[i];
+			histogram[G_ProfileBucket(frame->scopes[i])]++;
+		}
+
+		line = va("%-22s %6.2f %5i |", profileNames[i], (float)total / count, peak);
+		for(j = 0; j < PROFILE_BUCKETS; j++) line = va("%s %5i", line, histogram[j]);
+		print("%s\n", line);
+	}
+
+	print("slowest frames:\n");
+	for(i = 0; i < profile.numWorst; i++) {
+		frame = &profile.worst[i];
+		line = va("%8i %4i msec:", frame->time, frame->total);
+		for(j = 0; j < PROF_NUM; j++) {
+			if(frame->scopes[j]) line = va("%s %s %i", line, profileNames[j], frame->scopes[j]);
+		}
+		print("%s\n", line);
+	}
+}
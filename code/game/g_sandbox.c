@@ -61,6 +61,7 @@ static void G_TouchProp(gentity_t *self, gentity_t *other, trace_t *trace) {
 		VectorSet(other->r.maxs, 25, 25, 15);
 		self->think = Phys_VehiclePlayer;
 		self->nextthink = level.time + 1;
+		Phys_Wake(self);
 	}
 }
 
@@ -78,7 +79,7 @@ static void setModel(gentity_t *ent, char *modelName) {
 	}
 
 	ent->s.modelindex = G_ModelIndex(modelName);
-	CopyAlloc(ent->model, modelName);
+	G_SetEntityString(ent, &ent->model, modelName);
 
 	if(len >= 4 && !Q_stricmp(ent->model + len - 4, ".md3")) ent->model[len - 4] = '\0';
 
@@ -95,7 +96,7 @@ void SP_sandbox_prop(gentity_t *ent) {
 	qboolean spawn_entity = qfalse;
 
 	// Create entity
-	CopyAlloc(ent->classname, ent->sb_class);
+	G_SetEntityString(ent, &ent->classname, ent->sb_class);
 
 	// Origin
 	VectorCopy(ent->s.origin, ent->s.pos.trBase);    // Client
@@ -208,8 +209,8 @@ void G_BuildProp(char *arg02, char *arg03, vec3_t xyz, gentity_t *player, char *
 
 	// Create entity
 	ent = G_Spawn();
-	CopyAlloc(ent->classname, arg03);
-	CopyAlloc(ent->sb_class, arg03);
+	G_SetEntityString(ent, &ent->classname, arg03);
+	G_SetEntityString(ent, &ent->sb_class, arg03);
 	for(i = 0; i < gameInfoSandboxSpawnsNum; i++) { // Check allowed sandbox list
 		if(!strcmp(ent->classname, gameInfoSandboxSpawns[i])) {
 			allow_spawn = qtrue;
@@ -266,7 +267,7 @@ void G_BuildProp(char *arg02, char *arg03, vec3_t xyz, gentity_t *player, char *
 
 		// Sound
 		ent->s.loopSound = G_SoundIndex(arg11);
-		CopyAlloc(ent->sb_sound, arg11);
+		G_SetEntityString(ent, &ent->sb_sound, arg11);
 
 		// HP
 		ent->health = atoi(arg12);
@@ -370,6 +371,9 @@ void G_ModProp(gentity_t *targ, gentity_t *attacker, char *arg01, char *arg02, c
 
 	if(!G_PlayerIsOwner(attacker, entity)) return;
 
+	Phys_Wake(entity);
+	entity->saveDirty = qtrue;
+
 	if(attacker->tool_id == TL_CREATE) {
 		// client-side command for spawn prop
 	}
@@ -522,7 +526,7 @@ void G_ModProp(gentity_t *targ, gentity_t *attacker, char *arg01, char *arg02, c
 				}
 			} else {
 				entity = G_FindWeldEntity(entity); // find weld root or return ent
-				attacker->tool_entity->physParentEnt = entity;
+				Phys_Weld(attacker->tool_entity, entity);
 
 				// Save origin
 				VectorSubtract(attacker->tool_entity->r.currentOrigin, entity->r.currentOrigin, attacker->tool_entity->phys_relativeOrigin);
@@ -551,7 +555,6 @@ void G_ModProp(gentity_t *targ, gentity_t *attacker, char *arg01, char *arg02, c
 				VectorCopy(relForward, attacker->tool_entity->phys_rv_0);
 				VectorCopy(relRight, attacker->tool_entity->phys_rv_1);
 				VectorCopy(relUp, attacker->tool_entity->phys_rv_2);
-				entity->phys_weldedObjectsNum += 1;
 				attacker->tool_entity = NULL;
 			}
 		}
@@ -569,10 +572,10 @@ void G_ModProp(gentity_t *targ, gentity_t *attacker, char *arg01, char *arg02, c
 
 	if(attacker->tool_id == TL_BIND) {
 		if(atoi(arg05) == 0) {
-			CopyAlloc(entity->targetname, va("activate_%i_%s", attacker->s.clientNum, arg01));
+			G_SetEntityString(entity, &entity->targetname, va("activate_%i_%s", attacker->s.clientNum, arg01));
 		}
 		if(atoi(arg05) == 1) {
-			entity->targetname = NULL;
+			G_SetEntityString(entity, &entity->targetname, NULL);
 		}
 	}
 }
@@ -103,6 +103,46 @@ static field_t gameInfoFields[] = {
 };
 // clang-format on
 
+#define FIELD_HASH_SIZE 128
+static field_t *fieldHash[FIELD_HASH_SIZE];
+
+static int G_FieldHash(const char *name) {
+	int hash = 0;
+
+	while(*name) {
+		hash = hash * 31 + tolower(*name);
+		name++;
+	}
+	return hash & (FIELD_HASH_SIZE - 1);
+}
+
+/*
+===============
+G_FindField
+
+Looks up a gameInfoFields entry by name, the hash is built on first use
+===============
+*/
+static field_t *G_FindField(const char *name) {
+	static qboolean hashed = qfalse;
+	field_t *f;
+	int h;
+
+	if(!hashed) {
+		for(f = gameInfoFields; f->name; f++) {
+			h = G_FieldHash(f->name);
+			while(fieldHash[h] && Q_stricmp(fieldHash[h]->name, f->name)) h = (h + 1) & (FIELD_HASH_SIZE - 1);
+			if(!fieldHash[h]) fieldHash[h] = f; // first entry wins, as with the linear scan
+		}
+		hashed = qtrue;
+	}
+
+	for(h = G_FieldHash(name); fieldHash[h]; h = (h + 1) & (FIELD_HASH_SIZE - 1)) {
+		if(!Q_stricmp(fieldHash[h]->name, name)) return fieldHash[h];
+	}
+	return NULL;
+}
+
 // clang-format off
 spawn_t	gameInfoEntities[] = {
 	{"info_player_deathmatch", 		SP_info_player_deathmatch},
@@ -202,32 +242,29 @@ static void G_ParseField(const char *key, const char *value, gentity_t *ent) {
 	float v;
 	vec3_t vec;
 
-	for(f = gameInfoFields; f->name; f++) {
-		if(!Q_stricmp(f->name, key)) {
-			// found it
-			b = (byte *)ent;
+	f = G_FindField(key);
+	if(!f) return;
 
-			switch(f->type) {
-			case F_STRING: *(char **)(b + f->ofs) = G_NewString(value); break;
-			case F_VECTOR:
-				sscanf(value, "%f %f %f", &vec[0], &vec[1], &vec[2]);
-				((float *)(b + f->ofs))[0] = vec[0];
-				((float *)(b + f->ofs))[1] = vec[1];
-				((float *)(b + f->ofs))[2] = vec[2];
-				break;
-			case F_INT: *(int *)(b + f->ofs) = atoi(value); break;
-			case F_FLOAT: *(float *)(b + f->ofs) = atof(value); break;
-			case F_ANGLEHACK:
-				v = atof(value);
-				((float *)(b + f->ofs))[0] = 0;
-				((float *)(b + f->ofs))[1] = v;
-				((float *)(b + f->ofs))[2] = 0;
-				break;
-			default:
-			case F_IGNORE: break;
-			}
-			return;
-		}
+	b = (byte *)ent;
+
+	switch(f->type) {
+	case F_STRING: *(char **)(b + f->ofs) = G_NewString(value); break;
+	case F_VECTOR:
+		sscanf(value, "%f %f %f", &vec[0], &vec[1], &vec[2]);
+		((float *)(b + f->ofs))[0] = vec[0];
+		((float *)(b + f->ofs))[1] = vec[1];
+		((float *)(b + f->ofs))[2] = vec[2];
+		break;
+	case F_INT: *(int *)(b + f->ofs) = atoi(value); break;
+	case F_FLOAT: *(float *)(b + f->ofs) = atof(value); break;
+	case F_ANGLEHACK:
+		v = atof(value);
+		((float *)(b + f->ofs))[0] = 0;
+		((float *)(b + f->ofs))[1] = v;
+		((float *)(b + f->ofs))[2] = 0;
+		break;
+	default:
+	case F_IGNORE: break;
 	}
 }
 
@@ -422,45 +459,40 @@ void G_SpawnEntitiesFromString(void) {
 	level.spawning = qfalse; // any future calls to G_Spawn*() will be errors
 }
 
-#define MAX_TOKENNUM 1000000
-#define MAX_MAPFILE_LENGTH (4 * 1024 * 1024) // 1MB
-static char mapbuffer[MAX_MAPFILE_LENGTH];
-
-typedef enum { TOT_LPAREN, TOT_RPAREN, TOT_WORD, TOT_NUMBER, TOT_NIL, TOT_MAX } tokenType_t;
-
-#define TOKENVALUE_SIZE 128
-
-typedef struct {
-	char value[TOKENVALUE_SIZE];
-	int type;
-} token_t;
+// entities spawned by the last mapfile load, and the saved weld parent
+// numbers (phys_parent) mapped to the entities that now hold them, plus one
+static int mapfileLoaded[MAX_GENTITIES];
+static int mapfileNumLoaded;
+static int mapfileRemap[MAX_GENTITIES];
 
-token_t tokens2[MAX_TOKENNUM];
+/*
+================
+G_RelinkEntities
 
+Restores welds from the saved entity numbers in one pass over the
+entities of the last mapfile
+================
+*/
 static void G_RelinkEntities(void) {
-	int i, j;
-	int entNum, newEntNum;
+	gentity_t *ent, *parent;
+	int i;
 
-	for(i = 0; i < MAX_GENTITIES; i++) {
-		if(g_entities[i].phys_parent) {
-			entNum = g_entities[i].phys_parent;
-			newEntNum = g_entities[i].s.number;
-			for(j = 0; j < MAX_GENTITIES; j++) {
-				if(g_entities[j].phys_welded == entNum) {
-					g_entities[j].physParentEnt = G_FindEntityForEntityNum(newEntNum);
-					g_entities[i].phys_weldedObjectsNum += 1;
-				}
-			}
-		}
+	for(i = 0; i < mapfileNumLoaded; i++) {
+		ent = &g_entities[mapfileLoaded[i]];
+		if(!ent->inuse || ent->phys_welded <= 0 || ent->phys_welded >= MAX_GENTITIES) continue;
+		if(!mapfileRemap[ent->phys_welded]) continue;
+
+		parent = G_FindEntityForEntityNum(mapfileRemap[ent->phys_welded] - 1);
+		if(parent) Phys_Weld(ent, parent);
 	}
 }
 
-static qboolean SkippedChar(char in) { return (in == '\n' || in == '\r' || in == ';' || in == '\t' || in == ' '); }
-
 static qboolean G_ClassnameAllowed(char *input) {
 	int i;
 	char *classes_allowed[] = {"sandbox_prop", "sandbox_npc", 0};
 
+	if(!input) return qfalse;
+
 	for(i = 0; classes_allowed[i] != 0; i++) { // Allowed classlist
 		if(!strcmp(input, classes_allowed[i])) {
 			return qtrue;
@@ -484,203 +516,501 @@ static void G_ClearEntities(void) {
 	}
 }
 
-static int G_SetTokens2(char *in, char *out, int start) {
-	int i = 0;
-	while(in[start + i] != ' ') {
-		if(in[start + i] == '\0') {
-			out[i] = in[start + 1];
-			return MAX_MAPFILE_LENGTH;
-		}
-		out[i] = in[start + i];
-		i++;
+#define MAPFILE_CHUNK 0x10000
+
+typedef struct {
+	fileHandle_t f;
+	int remaining; // file bytes not yet read
+	int pos;
+	int len;
+	char buf[MAPFILE_CHUNK];
+} mapfileReader_t;
+
+static mapfileReader_t mapReader;
+
+static int G_MapfileChar(mapfileReader_t *r) {
+	if(r->pos >= r->len) {
+		if(r->remaining <= 0) return -1;
+		r->len = r->remaining < MAPFILE_CHUNK ? r->remaining : MAPFILE_CHUNK;
+		FS_Read(r->buf, r->len, r->f);
+		r->remaining -= r->len;
+		r->pos = 0;
 	}
-	out[i] = '\0';
-	return start + i + 1;
+	return (byte)r->buf[r->pos++];
 }
 
-static int G_SetTokenType2(char *value) {
-	int count = 0;
-	qboolean lpar = qfalse, rpar = qfalse, number = qfalse, character = qfalse;
-
-	while(value[count] != '\0') {
-		if(value[count] == '{')
-			lpar = qtrue;
-		else if(value[count] == '}')
-			rpar = qtrue;
-		else if(value[count] >= '0' && value[count] <= '9')
-			number = qtrue;
-		else if((value[count] >= 'a' && value[count] <= 'z') || (value[count] >= 'A' && value[count] <= 'Z'))
-			character = qtrue;
-		count++;
-	}
+// next byte without consuming it, refills the chunk if needed
+static int G_MapfilePeek(mapfileReader_t *r) {
+	int c;
 
-	if(lpar && !(rpar || number || character))
-		return TOT_LPAREN;
-	else if(rpar && !(lpar || number || character))
-		return TOT_RPAREN;
-	else if(number && !(lpar || rpar || character))
-		return TOT_NUMBER;
-	else if(character && !(lpar || rpar))
-		return TOT_WORD;
-	else
-		return TOT_NIL;
+	c = G_MapfileChar(r);
+	if(c != -1) r->pos--;
+	return c;
 }
 
-static int G_FindNextToken2(char *find, token_t *in, int start) {
-	int i;
-	int cmp;
+static qboolean G_MapfileRead(mapfileReader_t *r, void *out, int size) {
+	int n;
 
-	for(i = start; i < MAX_TOKENNUM; i++) {
-		cmp = strcmp(in[i].value, find);
-		if(cmp == 0) return i;
+	while(size > 0) {
+		if(r->pos >= r->len) {
+			if(G_MapfileChar(r) == -1) return qfalse;
+			r->pos--; // only wanted the refill
+		}
+		n = r->len - r->pos < size ? r->len - r->pos : size;
+		memcpy(out, r->buf + r->pos, n);
+		r->pos += n;
+		out = (byte *)out + n;
+		size -= n;
 	}
-	return -1;
+	return qtrue;
 }
 
-static qboolean G_AbeforeB2(char *A, char *B, token_t *in, int start) {
-	int a = G_FindNextToken2(A, in, start);
-	int b = G_FindNextToken2(B, in, start);
+/*
+================
+G_MapfileToken
 
-	if(b == -1 && a != -1) return qtrue;
-	if(a == -1 && b != -1) return qfalse;
-	if(a < b)
-		return qtrue;
-	else
-		return qfalse;
-}
+Reads the next token, braces are tokens of their own and quoted
+strings keep their spaces. Skips # and // comments.
+================
+*/
+static qboolean G_MapfileToken(mapfileReader_t *r, char *out, int size) {
+	int c, len = 0;
+
+	while(1) {
+		c = G_MapfileChar(r);
+		if(c == -1) return qfalse;
 
-static char *G_ClearString(char *input) {
-	if(input[0] == '"') {
-		input[0] = '\0';
-		input++;
+		if(c == '#' || (c == '/' && G_MapfilePeek(r) == '/')) { // comment to end of line
+			while(c != -1 && c != '\n' && c != '\r') c = G_MapfileChar(r);
+			continue;
+		}
+
+		if(c > ' ' && c != ';') break;
 	}
-	if(input[strlen(input) - 1] == '"') {
-		input[strlen(input) - 1] = '\0';
+
+	if(c == '"') {
+		while((c = G_MapfileChar(r)) != -1 && c != '"') {
+			if(len < size - 1) out[len++] = c;
+		}
+	} else if(c == '{' || c == '}') {
+		out[len++] = c;
+	} else {
+		do {
+			if(len < size - 1) out[len++] = c;
+			c = G_MapfileChar(r);
+		} while(c > ' ' && c != ';' && c != '{' && c != '}' && c != '"');
+		if(c != -1) r->pos--; // leave the delimiter for the next token
 	}
-	return input;
+
+	out[len] = '\0';
+	return qtrue;
 }
 
-static void G_LoadMapfileEntity(token_t *in, int min, int max) {
-	int i;
-	char *buf;
-	vec3_t vec;
+static field_t *G_MapfileField(const char *key) {
+	if(!strcmp(key, "team") || !strcmp(key, "angle")) return NULL;
+	return G_FindField(key);
+}
 
+static void G_LoadMapfileField(gentity_t *ent, const char *key, const char *value) {
 	field_t *field;
 	byte *b;
 
-	gentity_t *ent;
-	ent = G_Spawn();
+	field = G_MapfileField(key);
+	if(!field) return;
 
 	b = (byte *)ent;
 
-	for(i = min; i <= max; i++) {
-		for(field = gameInfoFields; field->name; field++) {
-			if(!strcmp(va("\"%s\"", field->name), in[i].value)) {
-				if(!strcmp(field->name, "team") || !strcmp(field->name, "angle")) break;
-				switch(field->type) {
-				case F_STRING: *(char **)(b + field->ofs) = G_NewString(G_ClearString(in[i + 1].value)); break;
-				case F_VECTOR:
-					buf = in[i + 1].value;
-					strcat(buf, " ");
-					strcat(buf, in[i + 2].value);
-					strcat(buf, " ");
-					strcat(buf, in[i + 3].value);
-					sscanf(G_ClearString(buf), "%f %f %f", &vec[0], &vec[1], &vec[2]);
-					((float *)(b + field->ofs))[0] = vec[0];
-					((float *)(b + field->ofs))[1] = vec[1];
-					((float *)(b + field->ofs))[2] = vec[2];
-					break;
-				case F_INT: *(int *)(b + field->ofs) = atoi(G_ClearString(in[i + 1].value)); break;
-				case F_FLOAT: *(float *)(b + field->ofs) = atof(G_ClearString(in[i + 1].value)); break;
-				default:
-				case F_IGNORE: break;
-				}
-				break;
-			}
-		}
+	switch(field->type) {
+	case F_STRING: G_SetEntityString(ent, (char **)(b + field->ofs), value); break;
+	case F_VECTOR: sscanf(value, "%f %f %f", &((float *)(b + field->ofs))[0], &((float *)(b + field->ofs))[1], &((float *)(b + field->ofs))[2]); break;
+	case F_INT: *(int *)(b + field->ofs) = atoi(value); break;
+	case F_FLOAT: *(float *)(b + field->ofs) = atof(value); break;
+	default:
+	case F_IGNORE: break;
 	}
+}
 
-	if(!G_CallSpawn(ent)) {
-		G_FreeEntity(ent);
+/*
+====================
+Binary mapfiles
+
+A header, the type and name of every gameInfoFields entry, the string
+pool, then one record per entity: a value count and (field index, value)
+pairs with strings as pool offsets. Fields are matched by name when
+loading, so saves survive changes to the field table.
+
+Autosave journals share the field table but have no pool. Each record
+starts with the entity slot it was saved from and carries its strings
+inline, a later record for the same slot replaces the earlier one.
+====================
+*/
+
+#define MAPFILE_IDENT (('M' << 24) + ('B' << 16) + ('S' << 8) + 'O') // "OSBM"
+#define MAPFILE_VERSION 1
+#define JOURNAL_IDENT (('J' << 24) + ('B' << 16) + ('S' << 8) + 'O') // "OSBJ"
+#define JOURNAL_VERSION 1
+#define JOURNAL_REMOVED 0xffff // value count of a removed slot
+#define JOURNAL_END -1         // slot of the record closing a compacted journal
+#define MAPFILE_MAXFIELDS 256
+#define MAPFILE_POOLSIZE 0x40000
+#define MAPFILE_POOLHASH 16384
+
+typedef struct {
+	int ident;
+	int version;
+	int numFields;
+	int numEntities;
+	int poolSize;
+} mapfileHeader_t;
+
+typedef struct {
+	int ident;
+	int version;
+	int generation;
+	int numFields;
+} journalHeader_t;
+
+typedef struct {
+	fileHandle_t f;
+	int len;
+	char buf[MAPFILE_CHUNK];
+} mapfileWriter_t;
+
+static mapfileWriter_t mapWriter;
+
+static char mapfilePool[MAPFILE_POOLSIZE];
+static int mapfilePoolSize;
+static int mapfilePoolHash[MAPFILE_POOLHASH]; // pool offset + 1
+static int mapfilePoolStrings;
+
+static int G_MapfileValueSize(int type) {
+	switch(type) {
+	case F_STRING:
+	case F_INT:
+	case F_FLOAT: return 4;
+	case F_VECTOR: return 12;
+	default: return 0; // never saved
 	}
 }
 
-static void G_LoadMapfile(char *filename) {
-	qboolean lastSpace = qtrue;
-	qboolean pgbreak = qfalse;
-	int i = 0;
-	int charCount = 0;
-	int tokenNum = 0;
-	int maxTokennum;
-	int lpar, rpar;
-	int len;
-	fileHandle_t f;
+/*
+================
+G_MapfilePoolString
 
-	len = FS_Open(filename, &f, FS_READ);
+Returns the pool offset of the string, adding it the first time it is
+seen, or -1 when the pool is full
+================
+*/
+static int G_MapfilePoolString(const char *string) {
+	const char *c;
+	int h = 0, len;
 
-	if(!f) {
-		print("%s", va(S_COLOR_YELLOW "mapfile not found: %s\n", filename));
-		return;
+	for(c = string; *c; c++) h = h * 31 + *c;
+	for(h &= MAPFILE_POOLHASH - 1; mapfilePoolHash[h]; h = (h + 1) & (MAPFILE_POOLHASH - 1)) {
+		if(!strcmp(mapfilePool + mapfilePoolHash[h] - 1, string)) return mapfilePoolHash[h] - 1;
 	}
 
-	iferr(len >= 2500000 * 6);
+	len = strlen(string) + 1;
+	if(mapfilePoolSize + len > MAPFILE_POOLSIZE || mapfilePoolStrings >= MAPFILE_POOLHASH / 2) return -1;
 
-	FS_Read(mapbuffer, len, f);
-	if(len <= 10) return;
-	mapbuffer[len] = 0;
-	FS_Close(f);
+	memcpy(mapfilePool + mapfilePoolSize, string, len);
+	mapfilePoolHash[h] = mapfilePoolSize + 1;
+	mapfilePoolSize += len;
+	mapfilePoolStrings++;
+	return mapfilePoolHash[h] - 1;
+}
 
-	G_ClearEntities();
+/*
+================
+G_SpawnMapfileEntity
+
+Returns NULL when the entities run out, G_Spawn hands back a freed
+slot then and the rest of the mapfile has nowhere to go
+================
+*/
+static gentity_t *G_SpawnMapfileEntity(void) {
+	gentity_t *ent;
+
+	if(mapfileNumLoaded < MAX_GENTITIES) {
+		ent = G_Spawn();
+		if(ent->inuse) return ent;
+	}
+
+	print("error: no free entities, mapfile stopped after %i entities\n", mapfileNumLoaded);
+	return NULL;
+}
+
+static qboolean G_LoadMapfileEntity(gentity_t *ent) {
+	if(!G_CallSpawn(ent)) {
+		G_FreeEntity(ent);
+		return qfalse;
+	}
+	if(!ent->inuse || mapfileNumLoaded >= MAX_GENTITIES) return qfalse; // freed by its spawn function
+
+	mapfileLoaded[mapfileNumLoaded++] = ent->s.number;
+	if(ent->phys_parent > 0 && ent->phys_parent < MAX_GENTITIES) mapfileRemap[ent->phys_parent] = ent->s.number + 1;
+	return qtrue;
+}
+
+static int G_LoadMapfileText(mapfileReader_t *r) {
+	char key[MAX_TOKEN_CHARS];
+	char value[MAX_TOKEN_CHARS];
+	gentity_t *ent;
+	int count = 0;
+
+	while(G_MapfileToken(r, key, sizeof(key))) {
+		if(strcmp(key, "{")) continue; // text between entities is ignored
+
+		ent = G_SpawnMapfileEntity();
+		if(!ent) break;
 
-	for(i = 0; i < MAX_MAPFILE_LENGTH; i++) {
-		// Filter comments( start at # and end at break )
-		if(mapbuffer[i] == '#') {
-			while(i < MAX_MAPFILE_LENGTH && !pgbreak) {
-				if(mapbuffer[i] == '\n' || mapbuffer[i] == '\r') pgbreak = qtrue;
-				i++;
+		while(1) {
+			if(!G_MapfileToken(r, key, sizeof(key))) {
+				print("error: \"}\" expected at end of file\n");
+				G_FreeEntity(ent);
+				ent = NULL;
+				break;
+			}
+			if(!strcmp(key, "}")) break;
+			if(!strcmp(key, "{") || !G_MapfileToken(r, value, sizeof(value)) || !strcmp(value, "{") || !strcmp(value, "}")) {
+				print("error: \"}\" expected at %s\n", key);
+				G_FreeEntity(ent);
+				ent = NULL;
+				break;
 			}
-			pgbreak = qfalse;
-			lastSpace = qtrue;
+			G_LoadMapfileField(ent, key, value);
 		}
+		if(!ent) break;
 
-		if(SkippedChar(mapbuffer[i])) {
-			if(!lastSpace) {
-				mapbuffer[charCount] = ' ';
-				charCount++;
-				lastSpace = qtrue;
-			}
+		if(G_LoadMapfileEntity(ent)) count++;
+	}
+
+	return count;
+}
+
+static qboolean G_ReadMapfileFields(mapfileReader_t *r, int numFields, field_t **fields, byte *types) {
+	char name[256];
+	byte len;
+	int i;
+
+	for(i = 0; i < numFields; i++) {
+		if(!G_MapfileRead(r, &types[i], 1) || !G_MapfileRead(r, &len, 1) || !G_MapfileRead(r, name, len)) return qfalse;
+		name[len] = '\0';
+		fields[i] = G_MapfileField(name);
+		if(fields[i] && fields[i]->type != types[i]) fields[i] = NULL; // field changed type, drop it
+	}
+	return qtrue;
+}
+
+/*
+================
+G_ReadMapfileValues
+
+Reads the values of one record straight into the entity fields, strings
+are pool offsets when there is a pool and inline otherwise. A NULL
+entity skips the record.
+================
+*/
+static qboolean G_ReadMapfileValues(mapfileReader_t *r, gentity_t *ent, int numValues, int numFields, field_t **fields, const byte *types, int poolSize) {
+	char string[MAX_TOKEN_CHARS];
+	unsigned short len;
+	byte index;
+	int value[3];
+	int i, size;
+
+	for(i = 0; i < numValues; i++) {
+		if(!G_MapfileRead(r, &index, 1) || index >= numFields) return qfalse;
+
+		if(types[index] == F_STRING && !poolSize) {
+			if(!G_MapfileRead(r, &len, sizeof(len)) || len >= sizeof(string) || !G_MapfileRead(r, string, len)) return qfalse;
+			string[len] = '\0';
+			if(ent && fields[index]) *(char **)((byte *)ent + fields[index]->ofs) = G_EntityString(ent, string);
 			continue;
 		}
 
-		lastSpace = qfalse;
-		mapbuffer[charCount] = mapbuffer[i];
-		charCount++;
+		size = G_MapfileValueSize(types[index]);
+		if(!size || !G_MapfileRead(r, value, size)) return qfalse;
+		if(!ent || !fields[index]) continue;
+
+		if(types[index] == F_STRING) {
+			if(value[0] >= 0 && value[0] < poolSize) *(char **)((byte *)ent + fields[index]->ofs) = G_EntityString(ent, mapfilePool + value[0]);
+		} else {
+			memcpy((byte *)ent + fields[index]->ofs, value, size);
+		}
+	}
+	return qtrue;
+}
+
+/*
+================
+G_LoadMapfileBinary
+
+Reads the records after the header straight into the entity fields
+================
+*/
+static int G_LoadMapfileBinary(mapfileReader_t *r, const mapfileHeader_t *header) {
+	field_t *fields[MAPFILE_MAXFIELDS];
+	byte types[MAPFILE_MAXFIELDS];
+	unsigned short numValues;
+	gentity_t *ent;
+	int i, count = 0;
+
+	if(!G_ReadMapfileFields(r, header->numFields, fields, types)) {
+		print("error: truncated mapfile field table\n");
+		return 0;
 	}
 
-	i = 0;
-	while(i < MAX_MAPFILE_LENGTH && tokenNum < MAX_TOKENNUM) {
-		i = G_SetTokens2(mapbuffer, tokens2[tokenNum].value, i);
-		tokens2[tokenNum].type = G_SetTokenType2(tokens2[tokenNum].value);
-		tokenNum++;
+	if(!G_MapfileRead(r, mapfilePool, header->poolSize) || (header->poolSize && mapfilePool[header->poolSize - 1])) {
+		print("error: bad mapfile string pool\n");
+		return 0;
 	}
-	maxTokennum = tokenNum;
 
-	print("Mapfile parser found %i tokens\n", maxTokennum);
+	for(i = 0; i < header->numEntities; i++) {
+		if(!G_MapfileRead(r, &numValues, sizeof(numValues))) break;
 
-	for(tokenNum = 0; tokenNum < maxTokennum; tokenNum++) {
-		if(strcmp(tokens2[tokenNum].value, "{") == 0) {
-			lpar = tokenNum;
-			if(G_AbeforeB2((char *)"{", (char *)"}", tokens2, tokenNum + 2)) {
-				print("error: \"}\" expected at %s\n", tokens2[tokenNum].value);
-				break;
+		ent = G_SpawnMapfileEntity();
+		if(!ent) return count;
+
+		if(!G_ReadMapfileValues(r, ent, numValues, header->numFields, fields, types, header->poolSize)) {
+			G_FreeEntity(ent);
+			break;
+		}
+
+		if(G_LoadMapfileEntity(ent)) count++;
+	}
+
+	if(i < header->numEntities) print("error: mapfile truncated after %i entities\n", count);
+	return count;
+}
+
+static int journalLatest[MAX_GENTITIES]; // record that holds the slot, + 1
+
+/*
+================
+G_LoadJournal
+
+Reads the journal twice, the first pass finds the last record of every
+slot and the second spawns only those, so nothing is spawned to be freed
+again. Sets complete when the journal was closed after a compaction.
+================
+*/
+static int G_LoadJournal(const char *filename, mapfileReader_t *r, const journalHeader_t *header, qboolean *complete) {
+	field_t *fields[MAPFILE_MAXFIELDS];
+	byte types[MAPFILE_MAXFIELDS];
+	journalHeader_t skip;
+	unsigned short numValues;
+	gentity_t *ent;
+	int pass, slot, record, count = 0;
+
+	memset(journalLatest, 0, sizeof(journalLatest));
+	*complete = qfalse;
+
+	for(pass = 0; pass < 2; pass++) {
+		if(pass) { // start over after the header
+			FS_Close(r->f);
+			r->remaining = FS_Open(filename, &r->f, FS_READ);
+			r->pos = r->len = 0;
+			if(!G_MapfileRead(r, &skip, sizeof(skip))) break;
+		}
+
+		if(!G_ReadMapfileFields(r, header->numFields, fields, types)) {
+			print("error: truncated journal field table\n");
+			return count;
+		}
+
+		for(record = 1; G_MapfileRead(r, &slot, sizeof(slot)) && G_MapfileRead(r, &numValues, sizeof(numValues)); record++) {
+			if(slot == JOURNAL_END) {
+				*complete = qtrue;
+				continue;
+			}
+			if(slot < 0 || slot >= MAX_GENTITIES) break;
+
+			if(numValues == JOURNAL_REMOVED) {
+				if(!pass) journalLatest[slot] = 0;
+				continue;
+			}
+
+			ent = NULL;
+			if(pass && journalLatest[slot] == record) {
+				ent = G_SpawnMapfileEntity();
+				if(!ent) return count;
 			}
-			rpar = G_FindNextToken2((char *)"}", tokens2, tokenNum + 2);
-			if(rpar != -1) {
-				G_LoadMapfileEntity(tokens2, lpar + 1, rpar - 1);
-				tokenNum = rpar;
+			if(!G_ReadMapfileValues(r, ent, numValues, header->numFields, fields, types, 0)) {
+				if(ent) G_FreeEntity(ent);
+				break;
 			}
+
+			if(!pass) journalLatest[slot] = record;
+			else if(ent && G_LoadMapfileEntity(ent)) count++;
 		}
 	}
+
+	return count;
+}
+
+/*
+================
+G_LoadMapfile
+
+Replaces the sandbox objects with the ones in a text or binary mapfile
+or an autosave journal. Returns qfalse when the file is missing or not
+a mapfile, or the journal was cut short. An empty scene is a valid load.
+================
+*/
+qboolean G_LoadMapfile(const char *filename) {
+	union {
+		int ident;
+		mapfileHeader_t mapfile;
+		journalHeader_t journal;
+	} header;
+	qboolean valid = qtrue, complete = qtrue;
+	int count, len;
+
+	len = FS_Open(filename, &mapReader.f, FS_READ);
+
+	if(!mapReader.f) {
+		print("%s", va(S_COLOR_YELLOW "mapfile not found: %s\n", filename));
+		return qfalse;
+	}
+
+	if(len <= 10) { // deleted mapfile
+		FS_Close(mapReader.f);
+		return qfalse;
+	}
+
+	mapReader.remaining = len;
+	mapReader.pos = mapReader.len = 0;
+
+	// text mapfiles can not start with an ident, so sniff the format
+	if(!G_MapfileRead(&mapReader, &header.ident, sizeof(header.ident))) header.ident = 0;
+	mapReader.pos = 0; // the header is well inside the first chunk
+
+	if(header.ident == MAPFILE_IDENT) {
+		valid = G_MapfileRead(&mapReader, &header.mapfile, sizeof(header.mapfile)) && header.mapfile.version == MAPFILE_VERSION && header.mapfile.numFields >= 0 && header.mapfile.numFields <= MAPFILE_MAXFIELDS && header.mapfile.numEntities >= 0 && header.mapfile.poolSize >= 0 && header.mapfile.poolSize <= MAPFILE_POOLSIZE;
+	} else if(header.ident == JOURNAL_IDENT) {
+		valid = G_MapfileRead(&mapReader, &header.journal, sizeof(header.journal)) && header.journal.version == JOURNAL_VERSION && header.journal.numFields >= 0 && header.journal.numFields <= MAPFILE_MAXFIELDS;
+	}
+
+	if(!valid) {
+		print("%s", va(S_COLOR_YELLOW "unsupported mapfile: %s\n", filename));
+		FS_Close(mapReader.f);
+		return qfalse;
+	}
+
+	G_ClearEntities();
+
+	memset(mapfileRemap, 0, sizeof(mapfileRemap));
+	mapfileNumLoaded = 0;
+
+	if(header.ident == MAPFILE_IDENT) count = G_LoadMapfileBinary(&mapReader, &header.mapfile);
+	else if(header.ident == JOURNAL_IDENT) count = G_LoadJournal(filename, &mapReader, &header.journal, &complete);
+	else count = G_LoadMapfileText(&mapReader);
+
+	FS_Close(mapReader.f);
+	print("Mapfile parser found %i entities\n", count);
+
+	G_RelinkEntities();
+	return complete;
 }
 
 void G_LoadMapfile_f(void) {
@@ -697,76 +1027,315 @@ void G_LoadMapfile_f(void) {
 	cvarSet("mapfile", filename);
 	cvarSet("lastmap", cvarString("sv_mapname"));
 
-	G_RelinkEntities();
-
 	trap_SendServerCommand(-1, "print \"^2Map loaded!\n\"");
 }
 
-void G_WriteMapfile_f(void) {
-	int i;
-	fileHandle_t f;
-	char *string;
-	char filename[MAX_QPATH];
-	field_t *field;
-	byte *b;
+static void G_MapfileWrite(mapfileWriter_t *w, const void *data, int size) {
+	int n;
 
-	if(trap_Argc() < 2) {
-		print("Usage: savemap <filename>\n");
-		return;
+	while(size > 0) {
+		if(w->len == MAPFILE_CHUNK) {
+			FS_Write(w->buf, w->len, w->f);
+			w->len = 0;
+		}
+		n = MAPFILE_CHUNK - w->len < size ? MAPFILE_CHUNK - w->len : size;
+		memcpy(w->buf + w->len, data, n);
+		w->len += n;
+		data = (const byte *)data + n;
+		size -= n;
 	}
+}
 
-	trap_Argv(1, filename, sizeof(filename));
+static void G_MapfileWriteString(mapfileWriter_t *w, const char *string) { G_MapfileWrite(w, string, strlen(string)); }
 
-	FS_Open(va("%s", filename), &f, FS_WRITE);
+qboolean G_MapfileSaved(gentity_t *ent) {
+	if(!ent->inuse) return qfalse;
+	if(!G_ClassnameAllowed(ent->classname)) return qfalse;
+	if(ent->flags & FL_DROPPED_ITEM) return qfalse;
+	return qtrue;
+}
 
-	string = va("//OpenSandbox Map File\n");
-	FS_Write(string, strlen(string), f);
+static void G_WriteMapfileText(mapfileWriter_t *w) {
+	int i;
+	field_t *field;
+	byte *b;
 
-	for(i = 0; i < MAX_GENTITIES; i++) {
-		if(!g_entities[i].inuse) continue;
+	G_MapfileWriteString(w, "//OpenSandbox Map File\n");
 
-		if(!G_ClassnameAllowed(g_entities[i].classname)) continue;
-		if(g_entities[i].flags & FL_DROPPED_ITEM) continue;
+	for(i = 0; i < MAX_GENTITIES; i++) {
+		if(!G_MapfileSaved(&g_entities[i])) continue;
 
 		b = (byte *)&g_entities[i];
 
-		string = va("{\n");
-		FS_Write(string, strlen(string), f);
+		G_MapfileWriteString(w, "{\n");
 
 		for(field = gameInfoFields; field->name; field++) {
 			switch(field->type) {
 			case F_STRING:
-				if(*(char **)(b + field->ofs)) {
-					string = va("   \"%s\"   \"%s\"\n", field->name, *(char **)(b + field->ofs));
-					FS_Write(string, strlen(string), f);
-				}
+				if(*(char **)(b + field->ofs)) G_MapfileWriteString(w, va("   \"%s\"   \"%s\"\n", field->name, *(char **)(b + field->ofs)));
 				break;
 			case F_VECTOR:
 				if((((float *)(b + field->ofs))[0] || ((float *)(b + field->ofs))[1] || ((float *)(b + field->ofs))[2])) {
-					string = va("   \"%s\"   \"%f %f %f\"\n", field->name, ((float *)(b + field->ofs))[0], ((float *)(b + field->ofs))[1], ((float *)(b + field->ofs))[2]);
-					FS_Write(string, strlen(string), f);
+					G_MapfileWriteString(w, va("   \"%s\"   \"%f %f %f\"\n", field->name, ((float *)(b + field->ofs))[0], ((float *)(b + field->ofs))[1], ((float *)(b + field->ofs))[2]));
 				}
 				break;
 			case F_INT:
-				if(*(int *)(b + field->ofs)) {
-					string = va("   \"%s\"   \"%i\"\n", field->name, *(int *)(b + field->ofs));
-					FS_Write(string, strlen(string), f);
-				}
+				if(*(int *)(b + field->ofs)) G_MapfileWriteString(w, va("   \"%s\"   \"%i\"\n", field->name, *(int *)(b + field->ofs)));
 				break;
 			case F_FLOAT:
-				if(*(float *)(b + field->ofs)) {
-					string = va("   \"%s\"   \"%f\"\n", field->name, *(float *)(b + field->ofs));
-					FS_Write(string, strlen(string), f);
-				}
+				if(*(float *)(b + field->ofs)) G_MapfileWriteString(w, va("   \"%s\"   \"%f\"\n", field->name, *(float *)(b + field->ofs)));
 				break;
 			default:
 			case F_IGNORE: break;
 			}
 		}
-		string = va("}\n\n");
-		FS_Write(string, strlen(string), f);
+		G_MapfileWriteString(w, "}\n\n");
 	}
+}
+
+/*
+================
+G_BuildMapfilePool
+
+Collects the strings of every saved entity, returns the number of
+entities or -1 when they do not fit the pool
+================
+*/
+static int G_BuildMapfilePool(void) {
+	int i, count = 0;
+	field_t *field;
+	char *string;
+
+	memset(mapfilePoolHash, 0, sizeof(mapfilePoolHash));
+	mapfilePoolSize = mapfilePoolStrings = 0;
+
+	for(i = 0; i < MAX_GENTITIES; i++) {
+		if(!G_MapfileSaved(&g_entities[i])) continue;
+
+		for(field = gameInfoFields; field->name; field++) {
+			if(field->type != F_STRING) continue;
+			string = *(char **)((byte *)&g_entities[i] + field->ofs);
+			if(string && G_MapfilePoolString(string) < 0) return -1;
+		}
+		count++;
+	}
+
+	return count;
+}
+
+static void G_WriteMapfileBinary(mapfileWriter_t *w, int numEntities) {
+	mapfileHeader_t header;
+	byte record[MAPFILE_MAXFIELDS * 13 + 2];
+	unsigned short numValues;
+	field_t *field;
+	byte *b, len;
+	int i, size, ofs;
+
+	header.ident = MAPFILE_IDENT;
+	header.version = MAPFILE_VERSION;
+	header.numFields = ARRAY_SIZE(gameInfoFields) - 1;
+	header.numEntities = numEntities;
+	header.poolSize = mapfilePoolSize;
+	iferr(header.numFields > MAPFILE_MAXFIELDS);
+	G_MapfileWrite(w, &header, sizeof(header));
+
+	for(field = gameInfoFields; field->name; field++) {
+		record[0] = field->type;
+		record[1] = len = strlen(field->name);
+		G_MapfileWrite(w, record, 2);
+		G_MapfileWrite(w, field->name, len);
+	}
+
+	G_MapfileWrite(w, mapfilePool, mapfilePoolSize);
+
+	for(i = 0; i < MAX_GENTITIES; i++) {
+		if(!G_MapfileSaved(&g_entities[i])) continue;
+
+		b = (byte *)&g_entities[i];
+		numValues = 0;
+		size = sizeof(numValues);
+
+		// same values as the text writer: everything that is set
+		for(field = gameInfoFields; field->name; field++) {
+			switch(field->type) {
+			case F_STRING:
+				if(!*(char **)(b + field->ofs)) continue;
+				ofs = G_MapfilePoolString(*(char **)(b + field->ofs));
+				memcpy(record + size + 1, &ofs, sizeof(ofs));
+				break;
+			case F_VECTOR:
+				if(!((float *)(b + field->ofs))[0] && !((float *)(b + field->ofs))[1] && !((float *)(b + field->ofs))[2]) continue;
+				memcpy(record + size + 1, b + field->ofs, sizeof(vec3_t));
+				break;
+			case F_INT:
+			case F_FLOAT:
+				if(!*(int *)(b + field->ofs)) continue;
+				memcpy(record + size + 1, b + field->ofs, sizeof(int));
+				break;
+			default: continue;
+			}
+			record[size] = field - gameInfoFields;
+			size += 1 + G_MapfileValueSize(field->type);
+			numValues++;
+		}
+
+		memcpy(record, &numValues, sizeof(numValues));
+		G_MapfileWrite(w, record, size);
+	}
+}
+
+/*
+================
+G_JournalHeader
+
+Writes the header and field table that start an autosave journal,
+returns the length or -1 when it does not fit
+================
+*/
+int G_JournalHeader(byte *out, int size, int generation) {
+	journalHeader_t header;
+	field_t *field;
+	int len, ofs;
+
+	header.ident = JOURNAL_IDENT;
+	header.version = JOURNAL_VERSION;
+	header.generation = generation;
+	header.numFields = ARRAY_SIZE(gameInfoFields) - 1;
+
+	ofs = sizeof(header);
+	if(ofs > size) return -1;
+	memcpy(out, &header, sizeof(header));
+
+	for(field = gameInfoFields; field->name; field++) {
+		len = strlen(field->name);
+		if(ofs + 2 + len > size) return -1;
+		out[ofs] = field->type;
+		out[ofs + 1] = len;
+		memcpy(out + ofs + 2, field->name, len);
+		ofs += 2 + len;
+	}
+	return ofs;
+}
+
+/*
+================
+G_JournalGeneration
+
+Returns the generation of an autosave journal, -1 when the file is not one
+================
+*/
+int G_JournalGeneration(const char *filename) {
+	journalHeader_t header;
+	fileHandle_t f;
+	int len;
+
+	len = FS_Open(filename, &f, FS_READ);
+	if(!f) return -1;
+
+	header.ident = 0;
+	if(len >= (int)sizeof(header)) FS_Read(&header, sizeof(header), f);
 	FS_Close(f);
+
+	if(header.ident != JOURNAL_IDENT || header.version != JOURNAL_VERSION) return -1;
+	return header.generation;
+}
+
+/*
+================
+G_JournalRecord
+
+Writes the state of a saved entity as a journal record for its slot, a
+NULL entity records the slot as removed and a negative slot closes a
+compacted journal. Returns the length or -1 when it does not fit.
+================
+*/
+int G_JournalRecord(byte *out, int size, int slot, gentity_t *ent) {
+	unsigned short numValues = 0, len;
+	field_t *field;
+	byte *b;
+	char *string;
+	int ofs, valueSize;
+
+	if(slot < 0) slot = JOURNAL_END;
+	else if(!ent) numValues = JOURNAL_REMOVED;
+
+	ofs = sizeof(slot) + sizeof(numValues);
+	if(ofs > size) return -1;
+	memcpy(out, &slot, sizeof(slot));
+
+	if(slot != JOURNAL_END && ent) {
+		b = (byte *)ent;
+		for(field = gameInfoFields; field->name; field++) {
+			switch(field->type) {
+			case F_STRING:
+				string = *(char **)(b + field->ofs);
+				if(!string) continue;
+				len = strlen(string);
+				if(len >= MAX_TOKEN_CHARS) len = MAX_TOKEN_CHARS - 1;
+				if(ofs + 1 + sizeof(len) + len > size) return -1;
+				memcpy(out + ofs + 1, &len, sizeof(len));
+				memcpy(out + ofs + 1 + sizeof(len), string, len);
+				valueSize = sizeof(len) + len;
+				break;
+			case F_VECTOR:
+				if(!((float *)(b + field->ofs))[0] && !((float *)(b + field->ofs))[1] && !((float *)(b + field->ofs))[2]) continue;
+				valueSize = sizeof(vec3_t);
+				break;
+			case F_INT:
+			case F_FLOAT:
+				if(!*(int *)(b + field->ofs)) continue;
+				valueSize = sizeof(int);
+				break;
+			default: continue;
+			}
+			if(field->type != F_STRING) {
+				if(ofs + 1 + valueSize > size) return -1;
+				memcpy(out + ofs + 1, b + field->ofs, valueSize);
+			}
+			out[ofs] = field - gameInfoFields;
+			ofs += 1 + valueSize;
+			numValues++;
+		}
+	}
+
+	memcpy(out + sizeof(slot), &numValues, sizeof(numValues));
+	return ofs;
+}
+
+/*
+================
+G_WriteMapfile_f
+
+savemap <filename> [binary]
+Text unless binary is asked for and the strings fit the pool
+================
+*/
+void G_WriteMapfile_f(void) {
+	char filename[MAX_QPATH];
+	char format[16];
+	int numEntities = -1;
+
+	if(trap_Argc() < 2) {
+		print("Usage: savemap <filename> [binary]\n");
+		return;
+	}
+
+	trap_Argv(1, filename, sizeof(filename));
+	trap_Argv(2, format, sizeof(format));
+
+	if(!Q_stricmp(format, "binary")) {
+		numEntities = G_BuildMapfilePool();
+		if(numEntities < 0) print(S_COLOR_YELLOW "savemap: string pool full, writing text\n");
+	}
+
+	FS_Open(va("%s", filename), &mapWriter.f, FS_WRITE);
+	mapWriter.len = 0;
+
+	if(numEntities >= 0) G_WriteMapfileBinary(&mapWriter, numEntities);
+	else G_WriteMapfileText(&mapWriter);
+
+	if(mapWriter.len) FS_Write(mapWriter.buf, mapWriter.len, mapWriter.f);
+	FS_Close(mapWriter.f);
 	trap_SendServerCommand(-1, "print \"^2Map saved!\n\"");
 }
 
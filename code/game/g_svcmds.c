@@ -89,6 +89,11 @@ struct {
     {"deletemap", G_DeleteMapfile_f},
     {"clearmap", G_ClearMap_f},
     {"loadmap", G_LoadMapfile_f},
+    {"loadautosave", G_LoadAutosave_f},
+
+    {"memstats", G_MemoryStats_f},
+    {"profile", G_Profile_f},
+    {"aistats", BotAIStats_f},
 };
 
 /*
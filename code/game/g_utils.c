@@ -4,38 +4,103 @@
 
 #include "../shared/javascript.h"
 
-static int G_FindConfigstringIndex(char *name, int start, int max, qboolean create) {
-	int i;
+/*
+================
+Configstring index
+
+The game is the only writer of the model and sound configstrings, so
+each table is read once per level and kept in a name hash from then on
+================
+*/
+
+#define CSTABLE_HASH 2048 // power of two, at least twice MAX_MODELS
+
+typedef struct {
+	int start;
+	int max;
+	int next; // first unused index, 0 until the table was read
+	char *names[MAX_MODELS];
+	short hash[CSTABLE_HASH]; // indexes, 0 is empty
+} csTable_t;
+
+static csTable_t csModels, csSounds;
+
+static int G_ConfigstringHash(const char *name) {
+	int hash = 0;
+
+	while(*name) hash = hash * 31 + *name++;
+	return hash & (CSTABLE_HASH - 1);
+}
+
+static void G_AddConfigstringIndex(csTable_t *table, int index, const char *name) {
+	int h;
+
+	table->names[index] = G_Alloc(strlen(name) + 1);
+	strcpy(table->names[index], name);
+
+	for(h = G_ConfigstringHash(name); table->hash[h]; h = (h + 1) & (CSTABLE_HASH - 1));
+	table->hash[h] = index;
+}
+
+static void G_ReadConfigstringTable(csTable_t *table) {
 	char s[MAX_STRING_CHARS];
+	int i;
+
+	for(i = 1; i < table->max; i++) {
+		trap_GetConfigstring(table->start + i, s, sizeof(s));
+		if(!s[0]) break;
+		G_AddConfigstringIndex(table, i, s);
+	}
+	table->next = i;
+}
+
+static int G_FindConfigstringIndex(csTable_t *table, char *name, qboolean create) {
+	int h, i;
 
 	if(!name || !name[0]) {
 		return 0;
 	}
 
-	for(i = 1; i < max; i++) {
-		trap_GetConfigstring(start + i, s, sizeof(s));
-		if(!s[0]) {
-			break;
-		}
-		if(!strcmp(s, name)) {
-			return i;
-		}
+	if(!table->next) G_ReadConfigstringTable(table);
+
+	for(h = G_ConfigstringHash(name); table->hash[h]; h = (h + 1) & (CSTABLE_HASH - 1)) {
+		if(!strcmp(table->names[table->hash[h]], name)) return table->hash[h];
 	}
 
 	if(!create) {
 		return 0;
 	}
 
-	iferr(i == max);
+	iferr(table->next == table->max);
 
-	trap_SetConfigstring(start + i, name);
+	i = table->next++;
+	trap_SetConfigstring(table->start + i, name);
+	G_AddConfigstringIndex(table, i, name);
 
 	return i;
 }
 
-int G_ModelIndex(char *name) { return G_FindConfigstringIndex(name, CS_MODELS, MAX_MODELS, qtrue); }
+/*
+================
+G_InitConfigstringIndex
 
-int G_SoundIndex(char *name) { return G_FindConfigstringIndex(name, CS_SOUNDS, MAX_SOUNDS, qtrue); }
+Forgets the tables, they are read again on first use since the names
+live in the level memory
+================
+*/
+void G_InitConfigstringIndex(void) {
+	memset(&csModels, 0, sizeof(csModels));
+	csModels.start = CS_MODELS;
+	csModels.max = MAX_MODELS;
+
+	memset(&csSounds, 0, sizeof(csSounds));
+	csSounds.start = CS_SOUNDS;
+	csSounds.max = MAX_SOUNDS;
+}
+
+int G_ModelIndex(char *name) { return G_FindConfigstringIndex(&csModels, name, qtrue); }
+
+int G_SoundIndex(char *name) { return G_FindConfigstringIndex(&csSounds, name, qtrue); }
 
 /*
 ================
@@ -214,44 +279,38 @@ void G_InitGentity(gentity_t *e) {
 	e->classname = "noclass";
 	e->s.number = e - g_entities;
 	e->r.ownerNum = ENTITYNUM_NONE;
+	e->saveDirty = qtrue;
 }
 
 /*
 =================
 G_Spawn
-Either finds a free entity, or allocates a new one.
+Either reuses the oldest freed entity, or allocates a new one.
 =================
 */
 gentity_t *G_Spawn(void) {
-	int i, force;
+	int num;
 	gentity_t *e;
 
-	e = NULL; // shut up warning
-	i = 0;    // shut up warning
-	for(force = 0; force < 2; force++) {
-		// if we go through all entities and can't find one to free,
-		// override the normal minimum times before use
-		e = &g_entities[MAX_CLIENTS];
-		for(i = MAX_CLIENTS; i < level.num_entities; i++, e++) {
-			if(e->inuse) {
-				continue;
-			}
+	// freed slots are queued in freetime order, so only the head can be old enough
+	if(level.freeEntityHead) {
+		num = level.freeEntityHead - 1;
+		e = &g_entities[num];
 
-			// the first couple seconds of server time can involve a lot of
-			// freeing and allocating, so relax the replacement policy
-			if(!force && e->freetime > level.startTime + 2000 && level.time - e->freetime < 1000) {
-				continue;
-			}
+		// the first couple seconds of server time can involve a lot of
+		// freeing and allocating, so relax the replacement policy
+		if(e->freetime <= level.startTime + 2000 || level.time - e->freetime >= 1000 || level.num_entities >= cvarTrackedInt(g_maxEntities) - 1) {
+			level.freeEntityHead = level.freeEntityNext[num];
+			if(!level.freeEntityHead) level.freeEntityTail = 0;
 
 			// reuse this slot
 			G_InitGentity(e);
 			return e;
 		}
-		if(i != cvarInt("g_maxEntities") - 1) {
-			break;
-		}
 	}
-	if(i >= cvarInt("g_maxEntities") - 1) {
+
+	e = &g_entities[level.num_entities];
+	if(level.num_entities >= cvarTrackedInt(g_maxEntities) - 1) {
 		print("G_Spawn: no free entities. Check g_maxEntities cvar\n");
 		G_FreeEntity(e);
 		return e;
@@ -274,6 +333,9 @@ Marks the entity as free
 =================
 */
 void G_FreeEntity(gentity_t *ed) {
+	int num;
+
+	Phys_Wake(ed);         // props resting on it start falling
 	trap_UnlinkEntity(ed); // unlink from world
 
 	if(ed->neverFree) return;
@@ -292,6 +354,18 @@ void G_FreeEntity(gentity_t *ed) {
 		if(ed->parent && ed->parent->client && ed->parent->client->pers.connected == CON_CONNECTED) DropClientSilently(ed->parent->s.clientNum);
 	}
 
+	if(ed->inuse && ed - g_entities >= MAX_CLIENTS) {
+		num = ed - g_entities;
+		level.freeEntityNext[num] = 0;
+		if(level.freeEntityTail) {
+			level.freeEntityNext[level.freeEntityTail - 1] = num + 1;
+		} else {
+			level.freeEntityHead = num + 1;
+		}
+		level.freeEntityTail = num + 1;
+	}
+
+	G_FreeEntityStrings(ed);
 	memset(ed, 0, sizeof(*ed));
 	ed->classname = "freed";
 	ed->freetime = level.time;
@@ -513,14 +587,14 @@ void CrosshairPointGravity(gentity_t *ent, int range, vec3_t outPoint) {
 }
 
 gentity_t *G_FindEntityForEntityNum(int entityNum) {
-	int i;
 	gentity_t *ent;
 
-	for(i = 0, ent = g_entities; i < level.num_entities; i++, ent++) {
-		if(ent && ent->s.number == entityNum && ent->inuse) return ent;
-	}
+	if(entityNum < 0 || entityNum >= level.num_entities) return NULL;
 
-	return NULL;
+	ent = &g_entities[entityNum];
+	if(!ent->inuse || ent->s.number != entityNum) return NULL;
+
+	return ent;
 }
 
 qboolean G_PlayerIsOwner(gentity_t *player, gentity_t *ent) {
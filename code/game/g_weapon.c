@@ -351,70 +351,101 @@ static void Lightning_Fire(gentity_t *ent, int weapon) {
 Toolgun type
 ===============
 */
+static int Toolgun_HashString(int hash, const char *s) {
+	while(s && *s) hash = (hash ^ (byte)*s++) * 16777619;
+	return (hash ^ 0xff) * 16777619; // field separator
+}
+
+static int Toolgun_HashInt(int hash, int value) { return (hash ^ value) * 16777619; }
+
+/*
+===============
+Toolgun_ModelToken
+
+Props carry their model in a configstring already, so the client
+gets "@index" instead of the path when one of them matches
+===============
+*/
+static const char *Toolgun_ModelToken(gentity_t *traceEnt) {
+	char s[MAX_STRING_CHARS];
+	int index[2];
+	int i, len;
+
+	index[0] = traceEnt->s.modelindex;
+	index[1] = traceEnt->s.modelindex2;
+	len = strlen(traceEnt->model);
+
+	for(i = 0; i < 2; i++) {
+		if(index[i] <= 0 || index[i] >= MAX_MODELS) continue;
+		trap_GetConfigstring(CS_MODELS + index[i], s, sizeof(s));
+		if(Q_stricmpn(s, traceEnt->model, len)) continue;
+		if(!s[len] || !Q_stricmp(s + len, ".md3")) return va("@%i", index[i]);
+	}
+
+	return traceEnt->model;
+}
+
+/*
+===============
+Weapon_Toolgun_Info
+
+Sends "t_info <class> <model> <material> <count>" when the aimed entity or
+its fields change, "-" marks an empty field and a bare "t_info" clears
+===============
+*/
 void Weapon_Toolgun_Info(gentity_t *ent) {
 	trace_t tr;
 	vec3_t end;
 	gentity_t *traceEnt;
-	int i;
-
-	char info_entity[MAX_ENTITYINFO][64];
+	gclient_t *client = ent->client;
+	char *className;
+	int hash;
 
-	// set aiming directions
-	AngleVectors(ent->client->ps.viewangles, forward, right, up);
+	traceEnt = NULL;
 
-	CalcMuzzlePoint(ent, forward, right, up, muzzle);
-	VectorMA(muzzle, gameInfoWeapons[ent->s.weapon].range, forward, end);
-	trap_Trace(&tr, muzzle, NULL, NULL, end, ent->s.number, MASK_SELECT);
+	if(gameInfoWeapons[ent->s.weapon].wType == WT_TOOLGUN) {
+		// set aiming directions
+		AngleVectors(client->ps.viewangles, forward, right, up);
 
-	traceEnt = &g_entities[tr.entityNum];
+		CalcMuzzlePoint(ent, forward, right, up, muzzle);
+		VectorMA(muzzle, gameInfoWeapons[ent->s.weapon].range, forward, end);
+		trap_Trace(&tr, muzzle, NULL, NULL, end, ent->s.number, MASK_SELECT);
 
-	if(!traceEnt->sandboxObject && traceEnt->npcType <= NT_PLAYER && traceEnt->s.eType != ET_ITEM) {
-		trap_SendServerCommand(ent->s.clientNum, va("t_info \"%s\"", ""));
-		return;
+		traceEnt = &g_entities[tr.entityNum];
+		if(!traceEnt->sandboxObject && traceEnt->npcType <= NT_PLAYER && traceEnt->s.eType != ET_ITEM) traceEnt = NULL;
 	}
 
-	if(gameInfoWeapons[ent->s.weapon].wType == WT_TOOLGUN) {
-		// Classname
-		if(!strcmp(traceEnt->sb_class, "none") || !strcmp(traceEnt->sb_class, "")) {
-			strcpy(info_entity[0], traceEnt->classname);
-		} else {
-			strcpy(info_entity[0], traceEnt->sb_class);
-		}
-
-		// Model
-		if(traceEnt->s.eType == ET_PLAYER) {
-			strcpy(info_entity[1], va("%i", traceEnt->s.clientNum));
-		} else if(traceEnt->s.eType == ET_ITEM) {
-			strcpy(info_entity[1], "<NULL>");
-		} else {
-			strcpy(info_entity[1], traceEnt->model);
+	if(!traceEnt) {
+		if(client->toolgunInfoEnt != ENTITYNUM_NONE) {
+			client->toolgunInfoEnt = ENTITYNUM_NONE;
+			trap_SendServerCommand(ent->s.clientNum, "t_info");
 		}
+		return;
+	}
 
-		// Material
-		if(traceEnt->sb_material) {
-			strcpy(info_entity[2], va("%i", traceEnt->sb_material));
-		} else {
-			strcpy(info_entity[2], "0");
-		}
+	if(!traceEnt->sb_class || !strcmp(traceEnt->sb_class, "none") || !strcmp(traceEnt->sb_class, "")) {
+		className = traceEnt->classname;
+	} else {
+		className = traceEnt->sb_class;
+	}
 
-		// Count
-		if(traceEnt->s.eType == ET_ITEM) {
-			strcpy(info_entity[3], va("%i", traceEnt->count));
-		} else {
-			strcpy(info_entity[3], "<NULL>");
-		}
+	hash = Toolgun_HashString(0x811c9dc5, className);
+	hash = Toolgun_HashInt(hash, traceEnt->s.eType);
+	hash = Toolgun_HashInt(hash, traceEnt->s.eType == ET_PLAYER ? traceEnt->s.clientNum : traceEnt->count);
+	hash = Toolgun_HashInt(hash, traceEnt->sb_material);
+	hash = Toolgun_HashString(hash, traceEnt->model);
 
-		for(i = 0; i < MAX_ENTITYINFO; i++) {
-			if(!strcmp(info_entity[i], "")) {
-				strcpy(info_entity[i], "<NULL>");
-			}
-		}
+	if(client->toolgunInfoEnt == traceEnt->s.number && client->toolgunInfoHash == hash) return;
+	client->toolgunInfoEnt = traceEnt->s.number;
+	client->toolgunInfoHash = hash;
 
-		// Send entityInfo
-		trap_SendServerCommand(ent->s.clientNum, va("t_info \"%s %s %s %s\"", info_entity[0], info_entity[1], info_entity[2], info_entity[3]));
+	if(traceEnt->s.eType == ET_PLAYER) {
+		trap_SendServerCommand(ent->s.clientNum, va("t_info %s %i %i -", className && className[0] ? className : "-", traceEnt->s.clientNum, traceEnt->sb_material));
+	} else if(traceEnt->s.eType == ET_ITEM) {
+		trap_SendServerCommand(ent->s.clientNum, va("t_info %s - %i %i", className && className[0] ? className : "-", traceEnt->sb_material, traceEnt->count));
+	} else {
+		trap_SendServerCommand(ent->s.clientNum, va("t_info %s %s %i -", className && className[0] ? className : "-", traceEnt->model && traceEnt->model[0] ? Toolgun_ModelToken(traceEnt) : "-", traceEnt->sb_material));
 	}
-
-	return;
 }
 
 /*
@@ -72,9 +72,17 @@ void ST_InitCGUI(const char *font) {
 }
 
 void ST_UpdateCGUI(void) {
-	customcolor_crosshair[0] = cvarFloat("cg_crosshairColorRed");
-	customcolor_crosshair[1] = cvarFloat("cg_crosshairColorGreen");
-	customcolor_crosshair[2] = cvarFloat("cg_crosshairColorBlue");
+	static cvarHandle_t crosshairColor[3] = {CVAR_NOHANDLE, CVAR_NOHANDLE, CVAR_NOHANDLE};
+
+	if(crosshairColor[0] == CVAR_NOHANDLE) {
+		crosshairColor[0] = cvarTrack("cg_crosshairColorRed");
+		crosshairColor[1] = cvarTrack("cg_crosshairColorGreen");
+		crosshairColor[2] = cvarTrack("cg_crosshairColorBlue");
+	}
+
+	customcolor_crosshair[0] = cvarTrackedFloat(crosshairColor[0]);
+	customcolor_crosshair[1] = cvarTrackedFloat(crosshairColor[1]);
+	customcolor_crosshair[2] = cvarTrackedFloat(crosshairColor[2]);
 }
 
 int ST_StringCount(const char *str) {
@@ -121,51 +129,62 @@ int ST_StringCount(const char *str) {
 	return i;
 }
 
-static void ST_DrawChars(int x, int y, const char *str, vec4_t color, int charw, int charh, int style, qboolean drawShadow) {
+/*
+====================
+Text layout cache
+
+Everything ST_DrawChars needs from a string is the glyph index, the pen
+position in characters and the color escapes, none of which depend on
+the position, size or style, so layouts are cached by string alone in a
+direct mapped table. Strings too long for a cache entry are laid out
+into a scratch layout on every draw.
+====================
+*/
+
+#define TEXT_CACHE_SIZE 512 // must be a power of two
+#define TEXT_LAYOUT_CHARS 96
+#define TEXT_SCRATCH_GLYPHS 4096
+
+typedef struct {
+	byte ch;
+	signed char color; // color index set before this glyph, -1 for none
+	unsigned short pen; // characters advanced before this glyph
+} textGlyph_t;
+
+typedef struct {
+	int hash;
+	char string[TEXT_LAYOUT_CHARS];
+	int count;   // same as ST_StringCount
+	int escapes; // same as ST_ColorEscapes
+	int leads;   // unicode lead bytes, they shift aligned text
+	int numGlyphs;
+	textGlyph_t *glyphs;
+} textLayout_t;
+
+static textLayout_t textCache[TEXT_CACHE_SIZE];
+static textGlyph_t textCacheGlyphs[TEXT_CACHE_SIZE][TEXT_LAYOUT_CHARS];
+static textLayout_t textScratch;
+static textGlyph_t textScratchGlyphs[TEXT_SCRATCH_GLYPHS];
+
+static void ST_BuildLayout(textLayout_t *layout, const char *str, int maxGlyphs) {
 	const char *s;
 	char ch;
 	int prev_unicode = 0;
-	vec4_t tempcolor;
-	float ax;
-	float ay;
-	float aw;
-	float ah;
-	float frow;
-	float fcol;
-	float alignstate = 0;
-	int fontRes = ST_GetFontRes(charh);
+	int color = -1, pending = -1;
+	int pen = 0;
+	textGlyph_t *glyph;
 
-	if(style & UI_CENTER) {
-		alignstate = 0.5;
-	}
-	if(style & UI_RIGHT) {
-		alignstate = 1;
-	}
-
-	// Set color for the text
-	trap_R_SetColor(color);
-
-	ax = x;
-	ay = y;
-	aw = charw;
-	ah = charh;
-	
-	ST_AdjustFrom640(&ax, &ay, &aw, &ah);
+	layout->escapes = layout->leads = layout->numGlyphs = 0;
 
-	s = str;
-	while(*s) {
-		if((*s == -48) || (*s == -47)) {
-			ax = ax + aw * alignstate;
-		}
-		s++;
+	for(s = str; *s; s++) {
+		if((*s == -48) || (*s == -47)) layout->leads++;
 	}
 
 	s = str;
 	while(*s) {
 		if(Q_IsColorString(s)) {
-			memcpy(tempcolor, g_color_table[ColorIndex(s[1])], sizeof(tempcolor));
-			tempcolor[3] = color[3];
-			if(!drawShadow) trap_R_SetColor(tempcolor);
+			pending = ColorIndex(s[1]);
+			layout->escapes++;
 			s += 2;
 			continue;
 		}
@@ -195,16 +214,94 @@ static void ST_DrawChars(int x, int y, const char *str, vec4_t color, int charw,
 				}
 			}
 
-			frow = (ch >> 4) * 0.0625;
-			fcol = (ch & 15) * 0.0625;
-			trap_R_DrawStretchPic(ax, ay, aw, ah, fcol, frow, fcol + 0.0625, frow + 0.0625, cgui.defaultFont[fontRes]);
+			if(layout->numGlyphs < maxGlyphs) {
+				glyph = &layout->glyphs[layout->numGlyphs++];
+				glyph->ch = ch & 255;
+				glyph->pen = pen;
+				// escapes that don't change the color need no syscall
+				glyph->color = -1;
+				if(pending != color) glyph->color = color = pending;
+			}
 		}
 
-		ax += aw * FONT_WIDTH;
+		pen++;
 		s++;
 	}
 
-	trap_R_SetColor(NULL);
+	layout->count = pen;
+}
+
+static textLayout_t *ST_GetLayout(const char *str) {
+	textLayout_t *layout;
+	const char *s;
+	int hash, len;
+
+	hash = 0;
+	for(s = str; *s; s++) hash = hash * 31 + (*s & 255);
+	len = s - str;
+
+	if(len >= TEXT_LAYOUT_CHARS) {
+		textScratch.glyphs = textScratchGlyphs;
+		ST_BuildLayout(&textScratch, str, TEXT_SCRATCH_GLYPHS);
+		return &textScratch;
+	}
+
+	layout = &textCache[hash & (TEXT_CACHE_SIZE - 1)];
+	if(layout->glyphs && layout->hash == hash && !strcmp(layout->string, str)) return layout;
+
+	layout->hash = hash;
+	memcpy(layout->string, str, len + 1);
+	layout->glyphs = textCacheGlyphs[layout - textCache];
+	ST_BuildLayout(layout, str, TEXT_LAYOUT_CHARS);
+	return layout;
+}
+
+static void ST_DrawChars(int x, int y, const textLayout_t *layout, vec4_t color, int charw, int charh, int style, qboolean drawShadow) {
+	const textGlyph_t *glyph;
+	vec4_t tempcolor;
+	float ax;
+	float ay;
+	float aw;
+	float ah;
+	float step;
+	float frow;
+	float fcol;
+	float alignstate = 0;
+	qhandle_t shader;
+	int i;
+
+	if(style & UI_CENTER) {
+		alignstate = 0.5;
+	}
+	if(style & UI_RIGHT) {
+		alignstate = 1;
+	}
+
+	// Set color for the text
+	trap_R_SetColor(color);
+
+	ax = x;
+	ay = y;
+	aw = charw;
+	ah = charh;
+
+	ST_AdjustFrom640(&ax, &ay, &aw, &ah);
+
+	ax += layout->leads * aw * alignstate;
+	step = aw * FONT_WIDTH;
+	shader = cgui.defaultFont[ST_GetFontRes(charh)];
+
+	for(i = 0, glyph = layout->glyphs; i < layout->numGlyphs; i++, glyph++) {
+		if(glyph->color >= 0 && !drawShadow) {
+			memcpy(tempcolor, g_color_table[glyph->color], sizeof(tempcolor));
+			tempcolor[3] = color[3];
+			trap_R_SetColor(tempcolor);
+		}
+
+		frow = (glyph->ch >> 4) * 0.0625;
+		fcol = (glyph->ch & 15) * 0.0625;
+		trap_R_DrawStretchPic(ax + glyph->pen * step, ay, aw, ah, fcol, frow, fcol + 0.0625, frow + 0.0625, shader);
+	}
 }
 
 void ST_DrawChar(float x, float y, int ch, int style, float *color, float size) {
@@ -240,11 +337,13 @@ void ST_DrawString(float x, float y, const char *str, int style, float *color, f
 	float charh;
 	float *drawcolor;
 	vec4_t dropcolor;
-	int len = ST_StringCount(str);
-	int esc = ST_ColorEscapes(str);
+	textLayout_t *layout;
 
 	if(!str) return;
 
+	layout = ST_GetLayout(str);
+	if(!layout->numGlyphs) return;
+
 	charw = BASEFONT_WIDTH * fontSize;
 	charh = BASEFONT_HEIGHT * fontSize;
 
@@ -256,11 +355,11 @@ void ST_DrawString(float x, float y, const char *str, int style, float *color, f
 
 	switch(style & UI_FORMATMASK) {
 	case UI_CENTER:
-		x = x - len * (charw * FONT_WIDTH) / 2;
-		x += esc * (charw * FONT_WIDTH);
+		x = x - layout->count * (charw * FONT_WIDTH) / 2;
+		x += layout->escapes * (charw * FONT_WIDTH);
 		break;
 
-	case UI_RIGHT: x = x - len * (charw * FONT_WIDTH); break;
+	case UI_RIGHT: x = x - layout->count * (charw * FONT_WIDTH); break;
 
 	default:
 		// nothing to do
@@ -270,10 +369,11 @@ void ST_DrawString(float x, float y, const char *str, int style, float *color, f
 	if(style & UI_DROPSHADOW) {
 		dropcolor[0] = dropcolor[1] = dropcolor[2] = 0;
 		dropcolor[3] = drawcolor[3];
-		ST_DrawChars(x + 1, y + 1, str, dropcolor, charw, charh, style, qtrue);
+		ST_DrawChars(x + 1, y + 1, layout, dropcolor, charw, charh, style, qtrue);
 	}
 
-	ST_DrawChars(x, y, str, drawcolor, charw, charh, style, qfalse);
+	ST_DrawChars(x, y, layout, drawcolor, charw, charh, style, qfalse);
+	trap_R_SetColor(NULL);
 }
 
 void ST_AdjustFrom640(float *x, float *y, float *w, float *h) {
@@ -315,38 +415,314 @@ Console Variables
 ====================
 */
 
-cvar_t cvarStorage[MAX_CVARS];
+// cvars read by name live in a dense slot table, found by name or engine cvar ID
+// through hash chains, with strings kept in a size-classed pool. A string that
+// outgrows its chunk moves, the old chunk is only reused after the next
+// ST_UpdateCvars, so a cvarString pointer stays valid until then.
+// MAX_CVAR_SLOTS is well above the engine's own cvar limit. Once the table
+// or the name list is full, further cvars are read straight from the engine
+// on every call instead of being cached
+#define MAX_CVAR_SLOTS 8192
+#define MAX_CVAR_NAMES (MAX_CVAR_SLOTS * 2) // every spelling a cvar was read by
+#define CVAR_HASH_SIZE (MAX_CVAR_SLOTS * 2)
+#define CVAR_POOL_SIZE 0x40000
+#define CVAR_CHUNK_CLASSES 5 // 16, 32, 64, 128, 256 bytes
+
+typedef struct {
+	int id;
+	int stringOfs;
+	int stringClass;
+	int nextId; // hash chain, slot + 1
+	float value;
+	int integer;
+} cvarSlot_t;
+
+typedef struct {
+	int nameOfs;
+	int slot;
+	int next; // hash chain, name + 1
+} cvarName_t;
+
+static cvarSlot_t cvarSlots[MAX_CVAR_SLOTS];
+static int numCvarSlots;
+static cvarName_t cvarNames[MAX_CVAR_NAMES];
+static int numCvarNames;
+static cvarSlot_t cvarUncachedSlot;
+static char cvarUncachedStrings[2][MAX_CVAR_STRING];
+static int cvarUncachedIndex;
+static int cvarNameHash[CVAR_HASH_SIZE];
+static int cvarIdHash[CVAR_HASH_SIZE];
+static char cvarPool[CVAR_POOL_SIZE];
+static int cvarPoolUsed;
+static int cvarChunkFree[CVAR_CHUNK_CLASSES];    // free lists, offset + 1
+static int cvarChunkRetired[MAX_CVAR_SLOTS];      // freed this frame, offset * 8 + class
+static int numCvarChunksRetired;
+static cvar_t cvarScratch;
+
+static int ST_CvarHashName(const char *name) {
+	int hash = 0;
+
+	while(*name) {
+		hash = hash * 31 + tolower(*name);
+		name++;
+	}
+	return (hash & 0x7fffffff) % CVAR_HASH_SIZE;
+}
+
+static qboolean ST_CvarPoolFits(int size) { return cvarPoolUsed + ((size + 3) & ~3) <= CVAR_POOL_SIZE; }
+
+static int ST_CvarPoolAlloc(int size) {
+	int ofs;
+
+	size = (size + 3) & ~3;
+	iferr(cvarPoolUsed + size > CVAR_POOL_SIZE);
+	ofs = cvarPoolUsed;
+	cvarPoolUsed += size;
+	return ofs;
+}
+
+static int ST_CvarChunkAlloc(int chunkClass) {
+	int ofs;
+
+	if(cvarChunkFree[chunkClass]) {
+		ofs = cvarChunkFree[chunkClass] - 1;
+		cvarChunkFree[chunkClass] = *(int *)(cvarPool + ofs);
+		return ofs;
+	}
+	return ST_CvarPoolAlloc(16 << chunkClass);
+}
+
+// the free list link overwrites the chunk, so chunks are only linked in once
+// nobody can hold their string any more
+static void ST_CvarChunkFree(int ofs, int chunkClass) {
+	if(numCvarChunksRetired >= MAX_CVAR_SLOTS) return; // leaked until the next ST_RegisterCvars
+	cvarChunkRetired[numCvarChunksRetired++] = ofs * 8 + chunkClass;
+}
+
+static void ST_CvarReleaseChunks(void) {
+	int i, ofs, chunkClass;
+
+	for(i = 0; i < numCvarChunksRetired; i++) {
+		ofs = cvarChunkRetired[i] >> 3;
+		chunkClass = cvarChunkRetired[i] & 7;
+		*(int *)(cvarPool + ofs) = cvarChunkFree[chunkClass];
+		cvarChunkFree[chunkClass] = ofs + 1;
+	}
+	numCvarChunksRetired = 0;
+}
+
+static void ST_CvarStoreString(cvarSlot_t *slot, const char *string) {
+	int len = strlen(string) + 1;
+	int chunkClass = 0;
+
+	if(len > MAX_CVAR_STRING) len = MAX_CVAR_STRING;
+	while((16 << chunkClass) < len) chunkClass++;
+
+	if(slot->stringOfs == -1 || chunkClass > slot->stringClass) {
+		if(slot->stringOfs != -1 && !cvarChunkFree[chunkClass] && !ST_CvarPoolFits(16 << chunkClass)) {
+			StringCopy(cvarPool + slot->stringOfs, string, 16 << slot->stringClass); // pool full, keep what fits
+			return;
+		}
+		if(slot->stringOfs != -1) ST_CvarChunkFree(slot->stringOfs, slot->stringClass);
+		slot->stringOfs = ST_CvarChunkAlloc(chunkClass);
+		slot->stringClass = chunkClass;
+	}
+
+	StringCopy(cvarPool + slot->stringOfs, string, len);
+}
+
+static void ST_ClearCvarSlots(void) {
+	numCvarSlots = 0;
+	numCvarNames = 0;
+	cvarPoolUsed = 0;
+	memset(cvarNameHash, 0, sizeof(cvarNameHash));
+	memset(cvarIdHash, 0, sizeof(cvarIdHash));
+	memset(cvarChunkFree, 0, sizeof(cvarChunkFree));
+	numCvarChunksRetired = 0;
+}
+
+// remembers a spelling so the next read by it skips the cvarID call
+static qboolean ST_CvarLinkName(const char *name, int nameHash, int slot) {
+	cvarName_t *entry;
+	int len = strlen(name) + 1;
+
+	if(numCvarNames >= MAX_CVAR_NAMES || !ST_CvarPoolFits(len)) return qfalse;
+
+	entry = &cvarNames[numCvarNames++];
+	entry->nameOfs = ST_CvarPoolAlloc(len);
+	strcpy(cvarPool + entry->nameOfs, name);
+	entry->slot = slot;
+	entry->next = cvarNameHash[nameHash];
+	cvarNameHash[nameHash] = numCvarNames;
+	return qtrue;
+}
+
+// read for a cvar that no longer fits the table, the string survives one more such read
+static cvarSlot_t *ST_CvarUncached(int id) {
+	cvarUncachedIndex ^= 1;
+	cvarUpdate(&cvarScratch, id);
+	cvarUncachedSlot.id = id;
+	cvarUncachedSlot.value = cvarScratch.value;
+	cvarUncachedSlot.integer = cvarScratch.integer;
+	StringCopy(cvarUncachedStrings[cvarUncachedIndex], cvarScratch.string, MAX_CVAR_STRING);
+	return &cvarUncachedSlot;
+}
+
+static char *ST_CvarSlotString(cvarSlot_t *slot) {
+	if(slot == &cvarUncachedSlot) return cvarUncachedStrings[cvarUncachedIndex];
+	return cvarPool + slot->stringOfs;
+}
+
+/*
+================
+ST_CvarSlot
+
+Finds or creates the slot for a cvar and refreshes it from the engine, NULL if the engine doesn't know it
+================
+*/
+static cvarSlot_t *ST_CvarSlot(const char *name) {
+	cvarSlot_t *slot;
+	int nameHash = ST_CvarHashName(name);
+	int idHash;
+	int id;
+	int i;
+
+	for(i = cvarNameHash[nameHash]; i; i = cvarNames[i - 1].next) {
+		if(!Q_stricmp(cvarPool + cvarNames[i - 1].nameOfs, name)) break;
+	}
+
+	if(i) {
+		slot = &cvarSlots[cvarNames[i - 1].slot];
+	} else {
+		id = cvarID(name);
+		if(id == -1) return NULL;
+
+		// another spelling of a cvar we already hold
+		idHash = id % CVAR_HASH_SIZE;
+		for(i = cvarIdHash[idHash]; i; i = cvarSlots[i - 1].nextId) {
+			if(cvarSlots[i - 1].id == id) break;
+		}
+
+		if(i) {
+			slot = &cvarSlots[i - 1];
+			ST_CvarLinkName(name, nameHash, i - 1);
+		} else {
+			// room for the name and a full length string, so the first store can't fail
+			if(numCvarSlots >= MAX_CVAR_SLOTS || !ST_CvarPoolFits(((strlen(name) + 4) & ~3) + MAX_CVAR_STRING)) return ST_CvarUncached(id);
+			if(!ST_CvarLinkName(name, nameHash, numCvarSlots)) return ST_CvarUncached(id);
+			slot = &cvarSlots[numCvarSlots++];
+			slot->id = id;
+			slot->stringOfs = -1;
+			slot->nextId = cvarIdHash[idHash];
+			cvarIdHash[idHash] = numCvarSlots;
+		}
+	}
+
+	cvarUpdate(&cvarScratch, slot->id);
+	slot->value = cvarScratch.value;
+	slot->integer = cvarScratch.integer;
+	ST_CvarStoreString(slot, cvarScratch.string);
+	return slot;
+}
+
+typedef struct {
+	char name[64];
+	int id; // -1 until the engine knows the cvar
+	int modificationCount;
+	cvar_t cvar;
+} trackedCvar_t;
+
+static trackedCvar_t trackedCvars[MAX_TRACKED_CVARS];
+static int numTrackedCvars;
+
+static void ST_RefreshTrackedCvar(trackedCvar_t *tc) {
+	cvar_t fresh;
+
+	if(tc->id == -1) {
+		tc->id = cvarID(tc->name);
+		if(tc->id == -1) return;
+	}
+
+	cvarUpdate(&fresh, tc->id);
+	if(strcmp(fresh.string, tc->cvar.string) || fresh.value != tc->cvar.value) {
+		tc->cvar = fresh;
+		tc->modificationCount++;
+	}
+}
 
 void ST_RegisterCvars(void) {
 	cvarReload();
+	ST_ClearCvarSlots();
 	ST_UpdateCvars();
 }
 
+/*
+================
+ST_UpdateCvars
+
+Refreshes only the tracked cvars, call once per frame. Strings returned
+by cvarString before this call may be overwritten after it
+================
+*/
 void ST_UpdateCvars(void) {
 	int i;
 
-	for(i = 0; i < MAX_CVARS; i++) {
-		cvarUpdate(&cvarStorage[i], i);
+	ST_CvarReleaseChunks();
+
+	for(i = 0; i < numTrackedCvars; i++) {
+		ST_RefreshTrackedCvar(&trackedCvars[i]);
+	}
+}
+
+/*
+================
+cvarTrack
+
+Returns a stable handle for the cvar, tracking the same name twice returns the same handle
+================
+*/
+cvarHandle_t cvarTrack(const char *name) {
+	trackedCvar_t *tc;
+	int i;
+
+	for(i = 0; i < numTrackedCvars; i++) {
+		if(!Q_stricmp(trackedCvars[i].name, name)) return i;
 	}
+
+	iferr(numTrackedCvars >= MAX_TRACKED_CVARS);
+
+	tc = &trackedCvars[numTrackedCvars];
+	StringCopy(tc->name, name, sizeof(tc->name));
+	tc->id = -1;
+	tc->modificationCount = 0;
+	memset(&tc->cvar, 0, sizeof(tc->cvar));
+	ST_RefreshTrackedCvar(tc);
+
+	return numTrackedCvars++;
 }
 
+int cvarTrackedInt(cvarHandle_t handle) { return trackedCvars[handle].cvar.integer; }
+
+float cvarTrackedFloat(cvarHandle_t handle) { return trackedCvars[handle].cvar.value; }
+
+char *cvarTrackedString(cvarHandle_t handle) { return trackedCvars[handle].cvar.string; }
+
+int cvarModified(cvarHandle_t handle) { return trackedCvars[handle].modificationCount; }
+
 int cvarInt(const char *name) {
-	int id = cvarID(name);
-	if(id == -1) return 0;
-	cvarUpdate(&cvarStorage[id], id);
-	return cvarStorage[id].integer;
+	cvarSlot_t *slot = ST_CvarSlot(name);
+	if(!slot) return 0;
+	return slot->integer;
 }
 
 float cvarFloat(const char *name) {
-	int id = cvarID(name);
-	if(id == -1) return 0.0f;
-	cvarUpdate(&cvarStorage[id], id);
-	return cvarStorage[id].value;
+	cvarSlot_t *slot = ST_CvarSlot(name);
+	if(!slot) return 0.0f;
+	return slot->value;
 }
 
 char *cvarString(const char *name) {
-	int id = cvarID(name);
-	if(id == -1) return "0";
-	cvarUpdate(&cvarStorage[id], id);
-	return cvarStorage[id].string;
+	cvarSlot_t *slot = ST_CvarSlot(name);
+	if(!slot) return "0";
+	return ST_CvarSlotString(slot);
 }
@@ -65,11 +65,21 @@ typedef struct {
 	char string[MAX_CVAR_STRING];
 } cvar_t;
 
+#define MAX_TRACKED_CVARS 256
+#define CVAR_NOHANDLE -1
+
 void ST_RegisterCvars(void);
 void ST_UpdateCvars(void);
 int cvarInt(const char *name);
 float cvarFloat(const char *name);
-char *cvarString(const char *name);
+char *cvarString(const char *name); // valid until the next ST_UpdateCvars
+
+// tracked cvars: resolved once, refreshed by ST_UpdateCvars, read without syscalls
+cvarHandle_t cvarTrack(const char *name);
+int cvarTrackedInt(cvarHandle_t handle);
+float cvarTrackedFloat(cvarHandle_t handle);
+char *cvarTrackedString(cvarHandle_t handle);
+int cvarModified(cvarHandle_t handle);
 
 /*
 ====================
@@ -291,22 +291,6 @@ typedef struct {
 
 #define Byte4Copy(a, b) ((b)[0] = (a)[0], (b)[1] = (a)[1], (b)[2] = (a)[2], (b)[3] = (a)[3])
 
-// clang-format off
-#ifdef GAME
-#define CopyAlloc(dest, src) do {\
-    if(src) { \
-        int len = strlen(src) + 1; \
-        dest = G_Alloc(len); \
-        if (dest != NULL) { \
-            strcpy(dest, src); \
-        } \
-    } else { \
-        dest = NULL; \
-    } \
-} while(0)
-#endif
-// clang-format on
-
 // clang-format off
 #define	SnapVector(v) {v[0]=((int)(v[0]));v[1]=((int)(v[1]));v[2]=((int)(v[2]));}
 // clang-format on
@@ -110,9 +110,11 @@ loop:
 	pn = (char *)a + n * es;
 
 	r = (int)(pa - (char *)a);
+	if(r > (int)(pb - pa)) r = (int)(pb - pa);
 	vecswap(a, pb - r, r);
 
 	r = (int)(pd - pc);
+	if(r > (int)(pn - pd - es)) r = (int)(pn - pd - es);
 	vecswap(pb, pn - r, r);
 
 	if((r = (int)(pb - pa)) > (int)es) qsort(a, r / es, es, cmp);
@@ -118,6 +118,11 @@ qboolean UI_ConsoleCommand(int realTime) {
 		return qtrue;
 	}
 
+	if(Q_stricmp(cmd, "ui_rescanfiles") == 0) {
+		UI_InvalidateFileIndex();
+		return qtrue;
+	}
+
 	return qfalse;
 }
 
@@ -165,6 +170,10 @@ void UI_DrawHandlePic(float x, float y, float w, float h, qhandle_t hShader) {
 }
 
 void UI_DrawModelElement(float x, float y, float w, float h, const char *model, float scale) {
+	UI_DrawModelHandle(x, y, w, h, trap_R_RegisterModel(model), trap_R_RegisterSkin(va("mtr/%s/%i.skin", model, 0)), scale);
+}
+
+void UI_DrawModelHandle(float x, float y, float w, float h, qhandle_t model, qhandle_t skin, float scale) {
 	refdef_t refdef;
 	refEntity_t ent;
 	vec3_t origin;
@@ -198,7 +207,7 @@ void UI_DrawModelElement(float x, float y, float w, float h, const char *model,
 	memset(&ent, 0, sizeof(ent));
 
 	AnglesToAxis(angles, ent.axis);
-	ent.hModel = trap_R_RegisterModel(model);
+	ent.hModel = model;
 	ent.shaderRGBA[0] = 128;
 	ent.shaderRGBA[1] = 128;
 	ent.shaderRGBA[2] = 128;
@@ -207,7 +216,7 @@ void UI_DrawModelElement(float x, float y, float w, float h, const char *model,
 	VectorCopy(origin, ent.lightingOrigin);
 	ent.renderfx = RF_LIGHTING_ORIGIN;
 	VectorCopy(ent.origin, ent.oldorigin);
-	ent.customSkin = trap_R_RegisterSkin(va("mtr/%s/%i.skin", model, 0));
+	ent.customSkin = skin;
 
 	trap_R_AddRefEntityToScene(&ent);
 	trap_R_RenderScene(&refdef);
@@ -222,6 +231,7 @@ void UI_Refresh(int realtime) {
 
 	if(!(trap_Key_GetCatcher() & KEYCATCH_UI)) return;
 
+	ST_UpdateCvars();
 	ST_UpdateCGUI();
 	UI_OnMapStatus();
 	consoleSync(&console, console.linescount);
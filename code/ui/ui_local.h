@@ -213,6 +213,7 @@ void UI_Shutdown(void);
 void UI_Init(void);
 void UI_DrawHandlePic(float x, float y, float w, float h, qhandle_t hShader);
 void UI_DrawModelElement(float x, float y, float w, float h, const char *model, float scale);
+void UI_DrawModelHandle(float x, float y, float w, float h, qhandle_t model, qhandle_t skin, float scale);
 
 // ui_connect.c
 void UI_DrawConnectScreen(qboolean overlay);
@@ -249,6 +250,9 @@ void Menu_ElementsDraw(void);
 void *Menu_CurrentItem(void);
 sfxHandle_t Menu_DefaultKey(int key);
 void Menu_Cache(void);
+void UI_InvalidateFileIndex(void);
+void UI_InvalidateFileIndexFor(const char *location, const char *extension);
+int UI_ListFiles(const char *location, const char *extension, char *names, int namesSize, char **list);
 void UI_FillList(menuelement_s *e, char *location, char *itemsLocation, char *extension, char *names, int namesSize, char **configlist);
 int UI_CountFiles(const char *location, const char *extension);
 void UI_FillListFromArray(menuelement_s *e, char **configlist, char **items, int maxItems);
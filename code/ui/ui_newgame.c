@@ -137,6 +137,7 @@ void UI_NewGame(void) {
 		UI_FillList(&newgame.e[0], "addons", "addons", ".cfg", newgame.names1, sizeof(newgame.names1), newgame.list1);
 	}
 	if(newgame_mode == NTB_DEMOS) {
+		UI_InvalidateFileIndexFor("demos", ".demo"); // demos are recorded while the game runs
 		UI_FillList(&newgame.e[0], "demos", "demos", ".demo", newgame.names1, sizeof(newgame.names1), newgame.list1);
 	}
 
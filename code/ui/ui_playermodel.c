@@ -192,7 +192,7 @@ static void PlayerModel_BuildList(void) {
 	s_playermodel.nummodels = 0;
 
 	// iterate directory of all player models
-	numdirs = FS_List(MODELDIR, "/", pm_dirlist, 131072);
+	numdirs = UI_ListFiles(MODELDIR, "/", pm_dirlist, 131072, NULL);
 	dirptr = pm_dirlist;
 	for(i = 0; i < numdirs && s_playermodel.nummodels < MAX_PLAYERMODELS; i++, dirptr += dirlen + 1) {
 		dirlen = strlen(dirptr);
@@ -203,7 +203,7 @@ static void PlayerModel_BuildList(void) {
 
 		// iterate all skin tga files in directory
 		defaultskin = NULL;
-		numfiles = FS_List(va(MODELDIR "/%s", dirptr), "", pm_filelist, 131072);
+		numfiles = UI_ListFiles(va(MODELDIR "/%s", dirptr), "", pm_filelist, 131072, NULL);
 		fileptr = pm_filelist;
 		for(j = 0; j < numfiles && s_playermodel.nummodels < MAX_PLAYERMODELS; j++, fileptr += filelen + 1) {
 			filelen = strlen(fileptr);
@@ -243,7 +243,7 @@ static void PlayerModel_LoadSkins(int modelnum) {
 	fullmodelname = s_playermodel.modelnames[modelnum] + strlen(MODELDIR) + 1;
 
 	// iterate all skin files in directory
-	numfiles = FS_List(va(MODELDIR "/%s", GUI_ModelName(fullmodelname)), "", pm_filelist, 131072);
+	numfiles = UI_ListFiles(va(MODELDIR "/%s", GUI_ModelName(fullmodelname)), "", pm_filelist, 131072, NULL);
 	fileptr = pm_filelist;
 
 	for(i = 0; i < numfiles && s_playermodel.numskins < MAX_PLAYERSKINS; i++, fileptr += filelen + 1) {
@@ -500,37 +500,115 @@ static void UI_ServerPlayerIcon(const char *modelAndSkin, char *iconName, int ic
 	}
 }
 
-static void DrawListItemImage(int x, int y, int w, int h, const char *path, menuelement_s *l, const char *itemname) {
-	const char *info;
-	char pic[MAX_QPATH];
+/*
+====================
+List icons
+
+The icon of a list item is looked up once, as an image, a model or the
+icon or world model of the item with that name, and the result is cached
+by path, missing icons included until the file index is invalidated.
+Paths too long for the cache compare by prefix and length. Lookups
+register media, so only LISTICON_BUDGET of them run per frame and the
+other items get their icons on the next frames.
+====================
+*/
+
+#define LISTICON_CACHE 4096 // must be a power of two
+#define LISTICON_BUDGET 8
+
+typedef enum { ICON_NONE, ICON_MISSING, ICON_SHADER, ICON_MODEL } listIconType_t;
+
+typedef struct {
+	int hash;
+	int length;
+	char path[MAX_QPATH];
+	listIconType_t type;
+	qhandle_t handle;
+	qhandle_t skin;
+} listIcon_t;
+
+static listIcon_t listIcons[LISTICON_CACHE];
+static int listIconFrame;
+static int listIconLookups;
+
+static void UI_SetListIconModel(listIcon_t *icon, const char *model) {
+	icon->type = ICON_MODEL;
+	icon->skin = trap_R_RegisterSkin(va("mtr/%s/%i.skin", model, 0));
+}
+
+// forgets the missing icons under location, or all of them for NULL
+static void UI_ClearMissingListIcons(const char *location) {
+	int i, len;
+
+	len = location ? strlen(location) : 0;
+	for(i = 0; i < LISTICON_CACHE; i++) {
+		if(listIcons[i].type != ICON_MISSING) continue;
+		if(location && (Q_stricmpn(listIcons[i].path, location, len) || listIcons[i].path[len] != '/')) continue;
+		listIcons[i].type = ICON_NONE;
+	}
+}
+
+static listIcon_t *UI_ListIcon(const char *path, const char *itemname) {
+	listIcon_t *icon;
+	const char *s;
 	item_t *it;
+	int hash;
 
-	l->generic.shader = trap_R_RegisterShaderNoMip(path);
-	if(l->generic.shader) {
-		UI_DrawHandlePic(x, y, w, h, l->generic.shader);
-		return;
+	hash = 0;
+	for(s = path; *s; s++) hash = hash * 31 + (*s & 255);
+
+	icon = &listIcons[hash & (LISTICON_CACHE - 1)];
+	if(icon->type != ICON_NONE && icon->hash == hash && icon->length == s - path && !Q_strncmp(icon->path, path, sizeof(icon->path) - 1)) return icon;
+
+	if(listIconFrame != uis.realtime) {
+		listIconFrame = uis.realtime;
+		listIconLookups = 0;
 	}
+	if(listIconLookups >= LISTICON_BUDGET) return NULL;
+	listIconLookups++;
 
-	l->generic.model = trap_R_RegisterModel(path);
-	if(l->generic.model) {
-		UI_DrawModelElement(x, y, w, h, path, l->range);
-		return;
+	icon->hash = hash;
+	icon->length = s - path;
+	StringCopy(icon->path, path, sizeof(icon->path));
+	icon->type = ICON_MISSING;
+	icon->skin = 0;
+
+	icon->handle = trap_R_RegisterShaderNoMip(path);
+	if(icon->handle) {
+		icon->type = ICON_SHADER;
+		return icon;
+	}
+
+	icon->handle = trap_R_RegisterModel(path);
+	if(icon->handle) {
+		UI_SetListIconModel(icon, path);
+		return icon;
 	}
 
 	it = UI_FindItem(itemname);
 	if(it && it->icon && it->classname) {
-		UI_DrawHandlePic(x, y, w, h, trap_R_RegisterShaderNoMip(it->icon));
-		return;
+		icon->handle = trap_R_RegisterShaderNoMip(it->icon);
+		icon->type = ICON_SHADER;
+		return icon;
 	}
 
 	it = UI_FindItemClassname(itemname);
 	if(it && it->world_model && it->classname) {
-		l->generic.model = trap_R_RegisterModel(it->world_model);
-		if(l->generic.model) {
-			UI_DrawModelElement(x, y, w, h, it->world_model, l->range);
-			return;
-		}
+		icon->handle = trap_R_RegisterModel(it->world_model);
+		if(icon->handle) UI_SetListIconModel(icon, it->world_model);
 	}
+
+	return icon;
+}
+
+static void DrawListItemImage(int x, int y, int w, int h, const char *path, menuelement_s *l, const char *itemname) {
+	listIcon_t *icon;
+
+	icon = UI_ListIcon(path, itemname);
+	if(!icon) return;
+
+	if(icon->type == ICON_SHADER) UI_DrawHandlePic(x, y, w, h, icon->handle);
+	if(icon->type == ICON_MODEL) UI_DrawModelHandle(x, y, w, h, icon->handle, icon->skin, l->range);
 }
 
 static void UI_DrawListItemSelection(menuelement_s *l, int i, int x, int y, int item_h, int grid_w) {
@@ -994,82 +1072,195 @@ static void UI_FindButtonPic(menuelement_s *e, int pic) {
 	}
 }
 
-void UI_FillList(menuelement_s *e, char *location, char *itemsLocation, char *extension, char *names, int namesSize, char **configlist) {
-	int i, len, validItems = 0;
-	char *configname;
-	qboolean skip = qfalse;
+/*
+====================
+File index
+
+Directory listings are cached by location and extension with the names
+already filtered, stripped of the extension and sorted, so reopening a
+menu only copies them out. UI_InvalidateFileIndex bumps the generation
+to make every cached listing stale and forgets the missing list icons,
+UI_InvalidateFileIndexFor does the same for one location. The pools are
+reclaimed when they run out of room, or right away when the stale
+listing is the newest one.
+====================
+*/
+
+#define FILE_INDEX_ENTRIES 128
+#define FILE_INDEX_POOL 0x100000   // name bytes
+#define FILE_INDEX_NAMES 0x20000   // name offsets
+#define FILE_INDEX_MAXFILES 65536  // per listing
+
+typedef struct {
+	char location[MAX_QPATH];
+	char extension[16];
+	int generation;
+	int firstPool;
+	int firstName;
+	int numNames;
+} fileIndex_t;
+
+static fileIndex_t fileIndex[FILE_INDEX_ENTRIES];
+static int fileIndexCount;
+static char fileIndexPool[FILE_INDEX_POOL];
+static int fileIndexPoolUsed;
+static int fileIndexNames[FILE_INDEX_NAMES];
+static int fileIndexNamesUsed;
+static int fileIndexGeneration;
+
+static const char *imageExtensions[] = {".png", ".jpg", ".tga", ".bmp", NULL};
+static const char *soundExtensions[] = {".wav", ".ogg", ".mp3", NULL};
+
+void UI_InvalidateFileIndex(void) {
+	fileIndexGeneration++;
+	UI_ClearMissingListIcons(NULL);
+}
 
-	e->string = itemsLocation;
-	if(!strcmp(extension, "$image") || !strcmp(extension, "$sound")) {
-		e->numitems = FS_List(location, "", names, namesSize);
-	} else {
-		e->numitems = FS_List(location, extension, names, namesSize);
+/*
+=================
+UI_InvalidateFileIndexFor
+
+Makes the listings of one location stale, for any extension when
+extension is NULL, and forgets the missing list icons under it
+=================
+*/
+void UI_InvalidateFileIndexFor(const char *location, const char *extension) {
+	fileIndex_t *index;
+	int i;
+
+	for(i = 0, index = fileIndex; i < fileIndexCount; i++, index++) {
+		if(index->generation != fileIndexGeneration || Q_stricmp(index->location, location)) continue;
+		if(extension && strcmp(index->extension, extension)) continue;
+		index->generation = fileIndexGeneration - 1;
 	}
-	e->itemnames = (const char **)configlist;
 
-	if(e->numitems == 0) { // Empty folder
-		strcpy(names, "Empty");
-		e->numitems = 1;
-	} else if(e->numitems > 65536) { // Limit
-		e->numitems = 65536;
+	// stale listings at the end give their room back
+	while(fileIndexCount && fileIndex[fileIndexCount - 1].generation != fileIndexGeneration) {
+		index = &fileIndex[--fileIndexCount];
+		fileIndexPoolUsed = index->firstPool;
+		fileIndexNamesUsed = index->firstName;
 	}
 
-	configname = names;
-	for(i = 0; i < e->numitems; i++) {
-		len = strlen(configname);
+	UI_ClearMissingListIcons(location);
+}
 
-		skip = qfalse;
+static int UI_MatchExtension(const char *name, int len, const char **extensions) {
+	int extlen;
 
-		if(!strcmp(extension, "$image")) {
-			if(!(Q_stricmp(configname + len - 4, ".png") == 0 || Q_stricmp(configname + len - 4, ".jpg") == 0 || Q_stricmp(configname + len - 4, ".tga") == 0 || Q_stricmp(configname + len - 4, ".bmp") == 0)) skip = qtrue;
-		} else if(!strcmp(extension, "$sound")) {
-			if(!(Q_stricmp(configname + len - 4, ".wav") == 0 || Q_stricmp(configname + len - 4, ".ogg") == 0 || Q_stricmp(configname + len - 4, ".mp3") == 0)) skip = qtrue;
-		}
+	for(; *extensions; extensions++) {
+		extlen = strlen(*extensions);
+		if(len >= extlen && !Q_stricmp(name + len - extlen, *extensions)) return extlen;
+	}
+	return -1;
+}
 
-		if(skip) {
-			configname += len + 1;
-			continue;
-		}
+static int QDECL UI_CompareFileNames(const void *a, const void *b) {
+	return Q_stricmp(fileIndexPool + *(const int *)a, fileIndexPool + *(const int *)b);
+}
 
-		if(!strcmp(extension, "$image")) {
-			if(Q_stricmp(configname + len - 4, ".png") == 0) configname[len - 4] = '\0';
-			if(Q_stricmp(configname + len - 4, ".jpg") == 0) configname[len - 4] = '\0';
-			if(Q_stricmp(configname + len - 4, ".tga") == 0) configname[len - 4] = '\0';
-			if(Q_stricmp(configname + len - 4, ".bmp") == 0) configname[len - 4] = '\0';
-		} else if(!strcmp(extension, "$sound")) {
-			if(Q_stricmp(configname + len - 4, ".wav") == 0) configname[len - 4] = '\0';
-			if(Q_stricmp(configname + len - 4, ".ogg") == 0) configname[len - 4] = '\0';
-			if(Q_stricmp(configname + len - 4, ".mp3") == 0) configname[len - 4] = '\0';
-		} else {
-			if(Q_stricmp(configname + len - strlen(extension), extension) == 0) configname[len - strlen(extension)] = '\0';
-		}
+static fileIndex_t *UI_FileIndex(const char *location, const char *extension) {
+	fileIndex_t *index;
+	const char *single[2];
+	const char **extensions;
+	qboolean filter;
+	char *name;
+	int i, len, extlen, numFiles;
 
-		e->itemnames[validItems++] = configname;
-		configname += len + 1;
+	for(i = 0, index = fileIndex; i < fileIndexCount; i++, index++) {
+		if(index->generation == fileIndexGeneration && !strcmp(index->location, location) && !strcmp(index->extension, extension)) return index;
 	}
 
-	e->numitems = UI_CountFiles(location, extension);
-}
+	// start over once a listing could overflow the pools
+	if(fileIndexCount == FILE_INDEX_ENTRIES || FILE_INDEX_POOL - fileIndexPoolUsed < FILE_INDEX_POOL / 2 || FILE_INDEX_NAMES - fileIndexNamesUsed < FILE_INDEX_MAXFILES) {
+		fileIndexCount = fileIndexPoolUsed = fileIndexNamesUsed = 0;
+	}
 
-int UI_CountFiles(const char *location, const char *extension) {
-	char tempNames[32000];
-	int count = 0;
+	index = &fileIndex[fileIndexCount++];
+	StringCopy(index->location, location, sizeof(index->location));
+	StringCopy(index->extension, extension, sizeof(index->extension));
+	index->generation = fileIndexGeneration;
+	index->firstPool = fileIndexPoolUsed;
+	index->firstName = fileIndexNamesUsed;
+	index->numNames = 0;
 
+	// the engine filters plain extensions itself, directory listings
+	// with "/" may come back without the slash
+	filter = qtrue;
 	if(!strcmp(extension, "$image")) {
-		count += FS_List(location, ".png", tempNames, sizeof(tempNames));
-		count += FS_List(location, ".jpg", tempNames, sizeof(tempNames));
-		count += FS_List(location, ".tga", tempNames, sizeof(tempNames));
-		count += FS_List(location, ".bmp", tempNames, sizeof(tempNames));
-		return count;
+		extensions = imageExtensions;
+		numFiles = FS_List(location, "", fileIndexPool + fileIndexPoolUsed, FILE_INDEX_POOL - fileIndexPoolUsed);
+	} else if(!strcmp(extension, "$sound")) {
+		extensions = soundExtensions;
+		numFiles = FS_List(location, "", fileIndexPool + fileIndexPoolUsed, FILE_INDEX_POOL - fileIndexPoolUsed);
+	} else {
+		single[0] = extension;
+		single[1] = NULL;
+		extensions = single;
+		filter = qfalse;
+		numFiles = FS_List(location, extension, fileIndexPool + fileIndexPoolUsed, FILE_INDEX_POOL - fileIndexPoolUsed);
+	}
+
+	name = fileIndexPool + fileIndexPoolUsed;
+	for(i = 0; i < numFiles; i++, name += len + 1) {
+		len = strlen(name);
+		if(index->numNames >= FILE_INDEX_MAXFILES) continue;
+
+		extlen = UI_MatchExtension(name, len, extensions);
+		if(extlen < 0) {
+			if(filter) continue;
+			extlen = 0;
+		}
+
+		name[len - extlen] = '\0';
+		fileIndexNames[fileIndexNamesUsed++] = name - fileIndexPool;
+		index->numNames++;
 	}
-	if(!strcmp(extension, "$sound")) {
-		count += FS_List(location, ".wav", tempNames, sizeof(tempNames));
-		count += FS_List(location, ".ogg", tempNames, sizeof(tempNames));
-		count += FS_List(location, ".mp3", tempNames, sizeof(tempNames));
-		return count;
+	fileIndexPoolUsed = name - fileIndexPool;
+
+	qsort(fileIndexNames + index->firstName, index->numNames, sizeof(fileIndexNames[0]), UI_CompareFileNames);
+	return index;
+}
+
+/*
+=================
+UI_ListFiles
+
+Copies the sorted names of the files in location with the extension,
+or any image or sound extension for "$image" and "$sound", stripped of
+the extension. list gets a pointer to every name if it is not NULL.
+=================
+*/
+int UI_ListFiles(const char *location, const char *extension, char *names, int namesSize, char **list) {
+	fileIndex_t *index;
+	const char *name;
+	int i, len, count;
+
+	index = UI_FileIndex(location, extension);
+
+	count = 0;
+	for(i = 0; i < index->numNames; i++) {
+		name = fileIndexPool + fileIndexNames[index->firstName + i];
+		len = strlen(name);
+		if(len + 1 > namesSize) break;
+
+		memcpy(names, name, len + 1);
+		if(list) list[count] = names;
+		count++;
+		names += len + 1;
+		namesSize -= len + 1;
 	}
 
-	return FS_List(location, extension, tempNames, sizeof(tempNames));
+	return count;
+}
+
+void UI_FillList(menuelement_s *e, char *location, char *itemsLocation, char *extension, char *names, int namesSize, char **configlist) {
+	e->string = itemsLocation;
+	e->itemnames = (const char **)configlist;
+	e->numitems = UI_ListFiles(location, extension, names, namesSize, configlist);
+}
+
+int UI_CountFiles(const char *location, const char *extension) {
+	return UI_FileIndex(location, extension)->numNames;
 }
 
 void UI_FillListFromArray(menuelement_s *e, char **configlist, char **items, int maxItems) {
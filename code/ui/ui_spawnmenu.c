@@ -332,6 +332,12 @@ void UI_SpawnMenu(void) {
 			UI_FillList(&spawnmenu.e[0], spawnmenu_path_folder, spawnmenu_path_icons, ".sbscript", spawnmenu.names1, sizeof(spawnmenu.names1), spawnmenu.list1);
 		}
 	}
+	// saves and user scripts are written while the game runs, list them fresh
+	if(spawnmenu_tab == TB_SCRIPTS) UI_InvalidateFileIndexFor("scripts/user", ".sbscript");
+	if(spawnmenu_tab == TB_SAVES) {
+		UI_InvalidateFileIndexFor("maps", ".ent");
+		UI_InvalidateFileIndexFor("screenshots/maps", NULL);
+	}
 	if(spawnmenu_tab == TB_SCRIPTS) UI_FillList(&spawnmenu.e[0], "scripts/user", "", ".sbscript", spawnmenu.names1, sizeof(spawnmenu.names1), spawnmenu.list1);
 	if(spawnmenu_tab == TB_TOOLS) UI_FillList(&spawnmenu.e[0], "scripts/tools", "", ".sbscript", spawnmenu.names1, sizeof(spawnmenu.names1), spawnmenu.list1);
 	if(spawnmenu_tab == TB_SAVES) UI_FillList(&spawnmenu.e[0], "maps", "screenshots/maps", ".ent", spawnmenu.names1, sizeof(spawnmenu.names1), spawnmenu.list1);
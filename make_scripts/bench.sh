@@ -0,0 +1,69 @@
+#!/bin/bash
+
+echo "---------------------------------------"
+echo "Native game benchmark"
+echo "Compile: gamebench (linux x86, no libc)"
+echo "---------------------------------------"
+
+cd "$(dirname "$0")/.."
+
+mkdir -p linux/build/bench
+
+# The module keeps its own libc and 32-bit varargs, so it is built the
+# way the VM sees it: i386, freestanding, no system headers, no aliasing
+# assumptions. The disabled warnings only cover long standing noise in
+# the game code, everything else stays visible.
+warn="-Wall -Wno-unused-variable -Wno-unused-but-set-variable -Wno-parentheses -Wno-maybe-uninitialized"
+cc="gcc -m32 -O2 -g $warn -fno-strict-aliasing -DGAME -DQVM -ffreestanding -nostdinc -fno-builtin -fno-stack-protector -fno-pie -fno-tree-loop-distribute-patterns -c $1"
+
+cd linux/build/bench
+
+# ########################################
+# Files to compile to           gamebench
+# ########################################
+
+$cc ../../../code/game/ai_main.c || exit 1
+$cc ../../../code/game/bg_misc.c || exit 1
+$cc ../../../code/game/bg_pmove.c || exit 1
+$cc ../../../code/game/bg_slidemove.c || exit 1
+$cc ../../../code/game/g_active.c || exit 1
+$cc ../../../code/game/g_alloc.c || exit 1
+$cc ../../../code/game/g_autosave.c || exit 1
+$cc ../../../code/game/g_bot.c || exit 1
+$cc ../../../code/game/g_client.c || exit 1
+$cc ../../../code/game/g_cmds.c || exit 1
+$cc ../../../code/game/g_combat.c || exit 1
+$cc ../../../code/game/g_items.c || exit 1
+$cc ../../../code/game/g_main.c || exit 1
+$cc ../../../code/game/g_misc.c || exit 1
+$cc ../../../code/game/g_mover.c || exit 1
+$cc ../../../code/game/g_physics.c || exit 1
+$cc ../../../code/game/g_profile.c || exit 1
+$cc ../../../code/game/g_sandbox.c || exit 1
+$cc ../../../code/game/g_session.c || exit 1
+$cc ../../../code/game/g_spawn.c || exit 1
+$cc ../../../code/game/g_svcmds.c || exit 1
+$cc ../../../code/game/g_target.c || exit 1
+$cc ../../../code/game/g_team.c || exit 1
+$cc ../../../code/game/g_trigger.c || exit 1
+$cc ../../../code/game/g_utils.c || exit 1
+$cc ../../../code/game/g_weapon.c || exit 1
+
+$cc ../../../code/shared/core.c || exit 1
+$cc ../../../code/shared/engine.c || exit 1
+$cc ../../../code/shared/javascript.c || exit 1
+$cc ../../../code/shared/javascript_func.c || exit 1
+$cc ../../../code/shared/system.c || exit 1
+
+$cc ../../../code/bench/bench_main.c || exit 1
+$cc ../../../code/bench/bench_syscalls.c || exit 1
+
+gcc -m32 -nostdlib -static -no-pie -o gamebench *.o || exit 1
+
+echo "-----------------"
+echo "gamebench compiled"
+echo "-----------------"
+
+# ########################################
+# End of compilation files, add yours here
+# ########################################
@@ -37,6 +37,7 @@ cd windows\build\game
 %cc% ../../../code/game/bg_slidemove.c
 %cc% ../../../code/game/g_active.c
 %cc% ../../../code/game/g_alloc.c
+%cc% ../../../code/game/g_autosave.c
 %cc% ../../../code/game/g_bot.c
 %cc% ../../../code/game/g_client.c
 %cc% ../../../code/game/g_cmds.c
@@ -46,6 +47,7 @@ cd windows\build\game
 %cc% ../../../code/game/g_misc.c
 %cc% ../../../code/game/g_mover.c
 %cc% ../../../code/game/g_physics.c
+%cc% ../../../code/game/g_profile.c
 %cc% ../../../code/game/g_sandbox.c
 %cc% ../../../code/game/g_session.c
 %cc% ../../../code/game/g_spawn.c
@@ -112,6 +114,7 @@ cd windows\build\cgame
 %cc% ../../../code/cgame/cg_localents.c
 %cc% ../../../code/cgame/cg_main.c
 %cc% ../../../code/cgame/cg_marks.c
+%cc% ../../../code/cgame/cg_particles.c
 %cc% ../../../code/cgame/cg_players.c
 %cc% ../../../code/cgame/cg_playerstate.c
 %cc% ../../../code/cgame/cg_predict.c
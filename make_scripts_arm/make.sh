@@ -34,6 +34,7 @@ $cc ../../../code/game/bg_pmove.c
 $cc ../../../code/game/bg_slidemove.c
 $cc ../../../code/game/g_active.c
 $cc ../../../code/game/g_alloc.c
+$cc ../../../code/game/g_autosave.c
 $cc ../../../code/game/g_bot.c
 $cc ../../../code/game/g_client.c
 $cc ../../../code/game/g_cmds.c
@@ -42,6 +43,7 @@ $cc ../../../code/game/g_items.c
 $cc ../../../code/game/g_main.c
 $cc ../../../code/game/g_misc.c
 $cc ../../../code/game/g_physics.c
+$cc ../../../code/game/g_profile.c
 $cc ../../../code/game/g_sandbox.c
 $cc ../../../code/game/g_session.c
 $cc ../../../code/game/g_spawn.c
@@ -104,6 +106,7 @@ $cc ../../../code/cgame/cg_info.c
 $cc ../../../code/cgame/cg_localents.c
 $cc ../../../code/cgame/cg_main.c
 $cc ../../../code/cgame/cg_marks.c
+$cc ../../../code/cgame/cg_particles.c
 $cc ../../../code/cgame/cg_players.c
 $cc ../../../code/cgame/cg_playerstate.c
 $cc ../../../code/cgame/cg_predict.c